@@ -0,0 +1,37 @@
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+//
+// Request decoding of the one-off server, for scenarios from a handful of
+// drones to a large swarm. Its reply formatting is in sim/bench_reply.cc.
+//
+
+#include <benchmark/benchmark.h>
+
+#include "utils/json.h"
+
+#include <string>
+
+namespace
+{
+    std::string makeRequest(size_t drones)
+    {
+        std::string request = "{\"rid\": {\"n\": 1, \"t\": 1000, \"x\": 10.5, \"y\": 20.25, \"z\": 50, \"v\": 0, \"g\": 5.5, \"h\": 90}, \"drones\": [";
+        for (size_t i = 0; i < drones; i++) {
+            request += (i ? ", [" : "[") + std::to_string(i + 2) + ", " + utils::json_number(i * 3.25) + ", "
+                     + utils::json_number(1000 - i * 0.75) + ", 50, 5.5, 180, 0]";
+        }
+        return request + "]}";
+    }
+
+    void parseRequest(benchmark::State& state)
+    {
+        std::string request = makeRequest(state.range(0));
+        for (auto _ : state) {
+            utils::JsonValue value = utils::json_parse(request);
+            benchmark::DoNotOptimize(value.object.size());
+        }
+        state.SetBytesProcessed(state.iterations() * request.size());
+    }
+}
+
+BENCHMARK(parseRequest)->RangeMultiplier(4)->Range(3, 4096);
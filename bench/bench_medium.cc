@@ -0,0 +1,71 @@
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+//
+// Radio medium kernels: batch path loss from one transmitter to a swarm of
+// receivers, and the fan-out overhead of the reception worker pool.
+//
+
+#include <benchmark/benchmark.h>
+
+#include "rid_medium/RidBatchPathLoss.h"
+#include "utils/work_stealing_pool.h"
+
+#include <random>
+#include <vector>
+
+namespace
+{
+    // receivers scattered like the drones of a swarm scenario, 2.4 GHz transmitter
+    struct Swarm {
+        std::vector<double> x, y, z;
+        std::vector<double> distance, loss, power;
+        RidBatchPathLoss::Transmitter tx {500, 500, 50, 0.02, 0.125};
+
+        explicit Swarm(size_t n) : x(n), y(n), z(n), distance(n), loss(n), power(n) {
+            std::mt19937_64 rng(42);
+            std::uniform_real_distribution<double> horizontal(0, 1000), vertical(0, 120);
+            for (size_t i = 0; i < n; i++) {
+                x[i] = horizontal(rng);
+                y[i] = horizontal(rng);
+                z[i] = vertical(rng);
+            }
+        }
+
+        RidBatchPathLoss::Receivers receivers() const { return {x.size(), x.data(), y.data(), z.data()}; }
+    };
+
+    void pathLoss(benchmark::State& state, RidBatchPathLoss::Model model, double alpha, RidBatchPathLoss::Isa isa)
+    {
+        if (isa > RidBatchPathLoss::detectIsa()) {
+            state.SkipWithError("instruction set not supported by this CPU");
+            return;
+        }
+        Swarm swarm(state.range(0));
+        RidBatchPathLoss batch(model, alpha, 1);
+        batch.setIsa(isa);
+        for (auto _ : state) {
+            batch.compute(swarm.tx, swarm.receivers(), swarm.distance.data(), swarm.loss.data(), swarm.power.data());
+            benchmark::DoNotOptimize(swarm.power.data());
+            benchmark::ClobberMemory();
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+
+    void parallelFor(benchmark::State& state)
+    {
+        utils::WorkStealingPool pool(state.range(1));
+        std::vector<double> out(state.range(0));
+        for (auto _ : state) {
+            pool.parallelFor(out.size(), [&] (size_t i) { out[i] = i * 0.5; });
+            benchmark::DoNotOptimize(out.data());
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+}
+
+BENCHMARK_CAPTURE(pathLoss, free_space_scalar, RidBatchPathLoss::FREE_SPACE, 2, RidBatchPathLoss::SCALAR)->RangeMultiplier(4)->Range(4, 4096);
+BENCHMARK_CAPTURE(pathLoss, free_space_avx2, RidBatchPathLoss::FREE_SPACE, 2, RidBatchPathLoss::AVX2)->RangeMultiplier(4)->Range(4, 4096);
+BENCHMARK_CAPTURE(pathLoss, free_space_avx512, RidBatchPathLoss::FREE_SPACE, 2, RidBatchPathLoss::AVX512)->RangeMultiplier(4)->Range(4, 4096);
+BENCHMARK_CAPTURE(pathLoss, log_distance_2_7_scalar, RidBatchPathLoss::LOG_DISTANCE, 2.7, RidBatchPathLoss::SCALAR)->RangeMultiplier(4)->Range(4, 4096);
+
+BENCHMARK(parallelFor)->ArgsProduct({{16, 256, 4096}, {1, 3, 7}})->UseRealTime();
@@ -0,0 +1,101 @@
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+//
+// Recorder hot paths: handing log records to the writer thread, appending
+// .npy rows and updating per-link statistics.
+//
+
+#include <benchmark/benchmark.h>
+
+#include "rid_recorder/RidLogRecord.h"
+#include "utils/npy_writer.h"
+#include "utils/running_stats.h"
+#include "utils/spsc_ring.h"
+
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace
+{
+    RidLogRecord makeRecord(uint64_t i)
+    {
+        RidLogRecord record = {};
+        record.kind = RIDLOG_RECEPTION;
+        record.serialNumber = i % 64;
+        record.host = i % 100;
+        record.timestamp = i * 100;
+        record.time = i * 0.1;
+        record.rssi = -70 - (i % 20);
+        record.x = record.y = record.z = i;
+        record.rxX = record.rxY = record.rxZ = -(double)i;
+        return record;
+    }
+
+    // the simulation thread pushing while a writer drains, as in RidLogRecorder
+    void logRingHandoff(benchmark::State& state)
+    {
+        utils::SpscRing<RidLogRecord> ring(state.range(0));
+        std::atomic<bool> stop{false};
+        std::thread writer([&] {
+            std::vector<RidLogRecord> batch(1024);
+            while (!stop.load(std::memory_order_relaxed))
+                if (ring.tryPop(batch.data(), batch.size()) == 0)
+                    std::this_thread::yield();
+            while (ring.tryPop(batch.data(), batch.size()) > 0)
+                ;
+        });
+        uint64_t i = 0;
+        for (auto _ : state) {
+            RidLogRecord record = makeRecord(i++);
+            while (!ring.tryPush(record))
+                std::this_thread::yield();
+        }
+        stop = true;
+        writer.join();
+        state.SetItemsProcessed(state.iterations());
+        state.SetBytesProcessed(state.iterations() * sizeof(RidLogRecord));
+    }
+
+    // the anchor rows of the localization dataset
+    void npyAppend(benchmark::State& state)
+    {
+        char path[] = "/tmp/uav_rid_bench_XXXXXX.npy";
+        int fd = mkstemps(path, 4);
+        if (fd < 0) {
+            state.SkipWithError("cannot create a temporary file");
+            return;
+        }
+        close(fd);
+        {
+            size_t anchors = state.range(0);
+            utils::NpyWriter<double> writer(path, {anchors, 5});
+            std::vector<double> row(anchors * 5, 1.5);
+            for (auto _ : state)
+                writer.append(row.data());
+            state.SetBytesProcessed(state.iterations() * row.size() * sizeof(double));
+        }
+        unlink(path);
+    }
+
+    void linkStatsUpdate(benchmark::State& state)
+    {
+        utils::RunningStats stats;
+        utils::FixedHistogram histogram(-110, -20, 45);
+        double rssi = -80;
+        for (auto _ : state) {
+            rssi = rssi < -100 ? -60 : rssi - 0.37;
+            stats.add(rssi);
+            histogram.add(rssi);
+        }
+        benchmark::DoNotOptimize(stats.getMean());
+        state.SetItemsProcessed(state.iterations());
+    }
+}
+
+BENCHMARK(logRingHandoff)->Arg(1024)->Arg(65536)->UseRealTime();
+BENCHMARK(npyAppend)->Arg(4)->Arg(64);
+BENCHMARK(linkStatsUpdate);
@@ -0,0 +1,73 @@
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+//
+// Dipole antenna gain: INET's analytic DipoleAntenna against the table
+// lookup of TabulatedDipoleAntenna, over the same random directions.
+//
+
+#include <benchmark/benchmark.h>
+
+#include "bench_kernel.h"
+
+#include "rid_antenna/TabulatedDipoleAntenna.h"
+
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace
+{
+    // opens up the gain classes, which are only used from within the antennas
+    class BenchAntenna : public TabulatedDipoleAntenna
+    {
+      public:
+        typedef DipoleAntenna::AntennaGain AnalyticGain;
+        typedef TabulatedDipoleAntenna::AntennaGain TabulatedGain;
+        typedef TabulatedDipoleAntenna::GainTable Table;
+    };
+
+    std::vector<Quaternion> makeDirections()
+    {
+        std::mt19937_64 rng(1);
+        std::normal_distribution<double> normal;
+        std::vector<Quaternion> directions;
+        for (int i = 0; i < 4096; i++) {
+            Coord target(normal(rng), normal(rng), normal(rng));
+            directions.push_back(Quaternion::rotationFromTo(Coord::X_AXIS, target / target.length()));
+        }
+        return directions;
+    }
+
+    void measure(benchmark::State& state, const IAntennaGain& gain)
+    {
+        std::vector<Quaternion> directions = makeDirections();
+        for (auto _ : state) {
+            double sum = 0;
+            for (auto& direction : directions)
+                sum += gain.computeGain(direction);
+            benchmark::DoNotOptimize(sum);
+        }
+        state.SetItemsProcessed(state.iterations() * directions.size());
+    }
+
+    void dipoleGainAnalytic(benchmark::State& state)
+    {
+        bench::setUpKernel();
+        BenchAntenna::AnalyticGain gain("z", m(0.1));
+        measure(state, gain);
+    }
+
+    // the table size is the argument, the default of the NED parameter is 1024
+    void dipoleGainTabulated(benchmark::State& state)
+    {
+        bench::setUpKernel();
+        BenchAntenna::AnalyticGain reference("z", m(0.1));
+        auto table = std::make_shared<const BenchAntenna::Table>(&reference, Coord::Z_AXIS, state.range(0));
+        BenchAntenna::TabulatedGain gain(table, reference.getMinGain(), reference.getMaxGain());
+        state.counters["max_error"] = table->computeMaxError(&reference);
+        measure(state, gain);
+    }
+}
+
+BENCHMARK(dipoleGainAnalytic);
+BENCHMARK(dipoleGainTabulated)->RangeMultiplier(4)->Range(64, 16384);
@@ -0,0 +1,89 @@
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+//
+// Beacon transmit path of RidBeaconMgmt: filling in the Remote ID fields
+// from the mobility, and the packet handoff up to where a receiver peeks
+// at the beacon again.
+//
+
+#include <benchmark/benchmark.h>
+
+#include "bench_kernel.h"
+
+#include "inet/common/packet/Packet.h"
+#include "inet/mobility/contract/IMobility.h"
+
+#include "rid_beacon/RidBeaconFrame_m.h"
+#include "rid_beacon/RidBeaconMgmt.h"
+
+using namespace inet;
+
+namespace
+{
+    // a drone flying north-east and climbing, without a module behind it
+    class StubMobility : public IMobility
+    {
+      protected:
+        Coord position = Coord(120.5, 840.25, 50);
+        Coord velocity = Coord(3.5, 4.25, 0.5);
+        Coord zero = Coord::ZERO;
+        Quaternion orientation = Quaternion::IDENTITY;
+
+      public:
+        virtual int getId() const override { return 0; }
+        virtual double getMaxSpeed() const override { return velocity.length(); }
+        virtual const Coord& getCurrentPosition() override { return position; }
+        virtual const Coord& getCurrentVelocity() override { return velocity; }
+        virtual const Coord& getCurrentAcceleration() override { return zero; }
+        virtual const Quaternion& getCurrentAngularPosition() override { return orientation; }
+        virtual const Quaternion& getCurrentAngularVelocity() override { return Quaternion::IDENTITY; }
+        virtual const Quaternion& getCurrentAngularAcceleration() override { return Quaternion::IDENTITY; }
+        virtual const Coord& getConstraintAreaMax() const override { return Coord::NIL; }
+        virtual const Coord& getConstraintAreaMin() const override { return Coord::NIL; }
+    };
+
+    // the frame as sendBeacon() sets it up before fillRidMsg()
+    Ptr<RidBeaconFrame> makeBody()
+    {
+        const auto& body = makeShared<RidBeaconFrame>();
+        body->setSSID("SSID");
+        body->setBeaconInterval(0.5);
+        body->setChannelNumber(1);
+        body->setChunkLength(B(8 + 2 + 2 + (2 + 4) + 2));
+        return body;
+    }
+
+    void beaconFill(benchmark::State& state)
+    {
+        bench::setUpKernel();
+        StubMobility mobility;
+        simtime_t time = 12.5;
+        for (auto _ : state) {
+            auto body = makeBody();
+            RidBeaconMgmt::fillRidFields(body, 42, time, &mobility);
+            benchmark::DoNotOptimize(body->getHeading());
+        }
+        state.SetItemsProcessed(state.iterations());
+    }
+
+    // fill, wrap in a packet as sendManagementFrame() does, and peek as handleBeaconFrame() does
+    void beaconEncode(benchmark::State& state)
+    {
+        bench::setUpKernel();
+        StubMobility mobility;
+        simtime_t time = 12.5;
+        for (auto _ : state) {
+            auto body = makeBody();
+            RidBeaconMgmt::fillRidFields(body, 42, time, &mobility);
+            auto packet = new Packet("Beacon");
+            packet->insertAtBack(body);
+            auto received = packet->peekAtFront<RidBeaconFrame>();
+            benchmark::DoNotOptimize(received->getPosX());
+            delete packet;
+        }
+        state.SetItemsProcessed(state.iterations());
+    }
+}
+
+BENCHMARK(beaconFill);
+BENCHMARK(beaconEncode);
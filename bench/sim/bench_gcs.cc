@@ -0,0 +1,99 @@
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+//
+// RssiMlatGcs: ingesting and grouping the reports about concurrent beacons
+// for 3-4096 receivers per beacon, and the multilateration solver behind a
+// fix for 3-1024 anchors.
+//
+
+#include <benchmark/benchmark.h>
+
+#include "bench_kernel.h"
+
+#include "detectors/rssi_mlat/RssiMlatGcs.h"
+#include "detectors/rssi_mlat/RssiMlatReport_m.h"
+
+#include <cmath>
+#include <vector>
+
+namespace
+{
+    // beacons on the air at the same time, each reported by every receiver
+    const int numBeacons = 8;
+
+    class BenchGcs : public RssiMlatGcs
+    {
+      public:
+        using RssiMlatGcs::handleMessage;
+        using RssiMlatGcs::deleteReports;
+        using RssiMlatGcs::runMultilateration;
+    };
+
+    // the module is never part of a network, so it lives as long as the process
+    BenchGcs *getGcs()
+    {
+        static BenchGcs *gcs = new BenchGcs();
+        return gcs;
+    }
+
+    // receivers on a circle around the transmitter, RSSI falling off with the distance like mlat.py expects
+    RssiMlatReport *makeReport(int beacon, int receiver, int numReceivers)
+    {
+        double angle = 2 * M_PI * receiver / numReceivers;
+        double distance = 200 + 50 * (receiver % 7);
+        auto report = new RssiMlatReport("RssiMlatReport");
+        report->setReceiverHostId(receiver);
+        report->setSenderSerialNumber(1000 + beacon);
+        report->setTimestamp(12500);
+        report->setRssi(16 - 20 * std::log10(distance * 100.6));
+        report->setTxPosX(500);
+        report->setTxPosY(500);
+        report->setTxPosZ(50);
+        report->setRxPosX(500 + distance * std::cos(angle));
+        report->setRxPosY(500 + distance * std::sin(angle));
+        report->setRxPosZ(30 + receiver % 5);
+        report->setRxTime(12.5);
+        return report;
+    }
+
+    // reports arrive interleaved across the beacons, as the receivers decode them
+    void gcsIngest(benchmark::State& state)
+    {
+        bench::setUpKernel();
+        BenchGcs *gcs = getGcs();
+        int numReceivers = state.range(0);
+        std::vector<RssiMlatReport *> reports;
+        for (auto _ : state) {
+            state.PauseTiming();
+            for (int receiver = 0; receiver < numReceivers; receiver++)
+                for (int beacon = 0; beacon < numBeacons; beacon++)
+                    reports.push_back(makeReport(beacon, receiver, numReceivers));
+            state.ResumeTiming();
+            for (auto report : reports)
+                gcs->handleMessage(report);
+            gcs->deleteReports();
+            reports.clear();
+        }
+        state.SetItemsProcessed(state.iterations() * numReceivers * numBeacons);
+    }
+
+    // one fix, including the round trip to mlat.py
+    void gcsSolve(benchmark::State& state)
+    {
+        bench::setUpKernel();
+        BenchGcs *gcs = getGcs();
+        int numAnchors = state.range(0);
+        std::vector<RssiMlatReport *> reports;
+        for (int receiver = 0; receiver < numAnchors; receiver++)
+            reports.push_back(makeReport(0, receiver, numAnchors));
+        for (auto _ : state)
+            gcs->runMultilateration(reports);
+        for (auto report : reports)
+            delete report;
+        state.SetItemsProcessed(state.iterations());
+    }
+}
+
+BENCHMARK(gcsIngest)->RangeMultiplier(4)->Range(3, 4096);
+// larger groups no longer fit the single command line argument that mlat.py is called with
+BENCHMARK(gcsSolve)->RangeMultiplier(4)->Range(3, 1024)->Unit(benchmark::kMillisecond);
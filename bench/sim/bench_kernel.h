@@ -0,0 +1,57 @@
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+//
+// A simulation kernel without a network, set up once per process for the
+// benchmarks in this directory, like the embedding API of src/rid_embed
+// does for whole runs. Messages, packets and simulation times need an
+// active simulation; modules are created on their own, without
+// parameters, and only their parameter-free paths are measured.
+//
+
+#ifndef __BENCH_KERNEL_H
+#define __BENCH_KERNEL_H
+
+#include <omnetpp.h>
+#include <omnetpp/cnullenvir.h>
+
+namespace bench
+{
+    using namespace omnetpp;
+
+    class EmptyConfig : public cConfiguration
+    {
+      protected:
+        class NullKeyValue : public KeyValue {
+          public:
+            virtual const char *getKey() const override {return nullptr;}
+            virtual const char *getValue() const override {return nullptr;}
+            virtual const char *getBaseDirectory() const override {return nullptr;}
+        };
+        NullKeyValue nullKeyValue;
+
+      protected:
+        virtual const char *substituteVariables(const char *value) const override {return value;}
+
+      public:
+        virtual const char *getConfigValue(const char *key) const override {return nullptr;}
+        virtual const KeyValue& getConfigEntry(const char *key) const override {return nullKeyValue;}
+        virtual const char *getPerObjectConfigValue(const char *objectFullPath, const char *keySuffix) const override {return nullptr;}
+        virtual const KeyValue& getPerObjectConfigEntry(const char *objectFullPath, const char *keySuffix) const override {return nullKeyValue;}
+    };
+
+    /** Makes sure the kernel is up, call at the start of every benchmark */
+    inline void setUpKernel()
+    {
+        static cSimulation *sim = [] {
+            static cStaticFlag staticFlag;
+            CodeFragments::executeAll(CodeFragments::STARTUP);
+            SimTime::setScaleExp(-12);
+            cSimulation *sim = new cSimulation("simulation", new cNullEnvir(0, nullptr, new EmptyConfig()));
+            cSimulation::setActiveSimulation(sim);
+            return sim;
+        }();
+        (void)sim;
+    }
+}
+
+#endif
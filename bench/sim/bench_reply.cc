@@ -0,0 +1,40 @@
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+//
+// Reply formatting of the one-off server for 3-4096 receiving drones, with
+// the server's own RidOneOffServer::formatSeries().
+//
+
+#include <benchmark/benchmark.h>
+
+#include "bench_kernel.h"
+
+#include "rid_one_off/RidOneOffServer.h"
+
+#include <map>
+#include <vector>
+
+namespace
+{
+    // every receiver decoded the beacon once, as in a one-off request
+    void formatSeries(benchmark::State& state)
+    {
+        bench::setUpKernel();
+        int numHosts = state.range(0);
+        std::vector<int> hostMap;
+        std::map<int, RidOneOffServer::Series> receptionPowers;
+        for (int i = 0; i < numHosts; i++) {
+            hostMap.push_back(i + 2);
+            RidOneOffServer::Series& series = receptionPowers[i];
+            series.times.push_back(SimTime(1000123456 + i * 37, SIMTIME_PS));
+            series.values.push_back(-60.0 - i * 0.013);
+        }
+        for (auto _ : state) {
+            std::string out = RidOneOffServer::formatSeries(receptionPowers, hostMap);
+            benchmark::DoNotOptimize(out.data());
+        }
+        state.SetItemsProcessed(state.iterations() * numHosts);
+    }
+}
+
+BENCHMARK(formatSeries)->RangeMultiplier(4)->Range(3, 4096);
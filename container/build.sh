@@ -9,7 +9,33 @@ opp_makemake -f --deep \
     -Isrc \
     -I$\(INET4_5_PROJ\)/src \
     -L$\(INET4_5_PROJ\)/out/clang-release/src \
-    -lINET$\(D\)
+    -lINET$\(D\) \
+    -lsqlite3
 
 make MODE=release -j$(nproc) clean
 make MODE=release -j$(nproc) all
+
+# native .vec extractor used by rid-one-off.sh
+clang++ -std=c++17 -O2 -o "$BASE_DIR/rid-vec-extract" "$BASE_DIR/rid-vec-extract.cc"
+
+# microbenchmarks of the simulation-independent components, run with ./uav_rid_bench
+clang++ -std=c++17 -O2 -I"$PROJ_DIR/src" -o "$BASE_DIR/uav_rid_bench" \
+    "$BASE_DIR"/bench/*.cc "$PROJ_DIR/src/rid_medium/RidBatchPathLoss.cc" \
+    -lbenchmark_main -lbenchmark -lpthread
+
+# libuavrid: the same objects plus the embedding API of src/rid_embed, without Cmdenv
+omnetpp_lib="$(dirname "$(command -v opp_run)")/../lib"
+clang++ -shared -o out/clang-release/libuavrid.so \
+    $(find out/clang-release/src -name '*.o') \
+    -L"$omnetpp_lib" -loppenvir -loppsim -loppnedxml -loppcommon \
+    -L"$BASE_DIR/inet4.5/out/clang-release/src" -lINET -lsqlite3 \
+    -Wl,-rpath,"$omnetpp_lib" -Wl,-rpath,"$BASE_DIR/inet4.5/out/clang-release/src"
+
+# microbenchmarks of the modules that need a simulation kernel, run with ./uav_rid_bench_sim
+clang++ -std=c++17 -O2 -DINET_IMPORT -I"$PROJ_DIR/src" -I"$omnetpp_lib/../include" -I"$BASE_DIR/inet4.5/src" \
+    -o "$BASE_DIR/uav_rid_bench_sim" "$BASE_DIR"/bench/sim/*.cc \
+    -L"$PROJ_DIR/out/clang-release" -luavrid \
+    -L"$omnetpp_lib" -loppenvir -loppsim -loppnedxml -loppcommon \
+    -L"$BASE_DIR/inet4.5/out/clang-release/src" -lINET \
+    -lbenchmark_main -lbenchmark -lpthread \
+    -Wl,-rpath,"$PROJ_DIR/out/clang-release" -Wl,-rpath,"$omnetpp_lib" -Wl,-rpath,"$BASE_DIR/inet4.5/out/clang-release/src"
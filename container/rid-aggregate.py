@@ -0,0 +1,237 @@
+#!/usr/bin/env python3
+
+import argparse
+import csv
+import glob
+import math
+import os
+import re
+import shlex
+import sys
+import time
+
+def parse_args():
+    p = argparse.ArgumentParser(
+        description="Aggregate the scalar results of many uav_rid repetitions into one summary table in constant memory.",
+        epilog="Runs are grouped into cells by config name and iteration variables, ignoring the repetition. "
+               "Every scalar, and every field of every statistic or histogram, gets a running mean, variance "
+               "and Student t confidence interval across the runs of its cell. Files are read one at a time "
+               "and discarded, so memory grows with the number of cells, not the number of runs.",
+    )
+    p.add_argument("inputs", nargs="*", help=".sca files or directories holding them")
+    p.add_argument("-o", "--output", default="-", help="summary CSV, '-' for stdout (default)")
+    p.add_argument("--confidence", type=float, default=0.95, help="confidence level of the intervals (default: 0.95)")
+    p.add_argument("--filter", default=None, help="only aggregate results whose 'module.name' matches this regex")
+    p.add_argument("--fields", default="mean,stddev,min,max,count",
+                   help="fields of statistics and histograms to aggregate (default: mean,stddev,min,max,count)")
+    p.add_argument("--watch", type=float, default=None, metavar="SECONDS",
+                   help="keep polling the input directories for new .sca files and rewrite the summary "
+                        "after each one, until interrupted")
+    args = p.parse_args()
+    if not args.inputs:
+        p.error("no inputs")
+    if not 0 < args.confidence < 1:
+        p.error("--confidence must be between 0 and 1")
+    return args
+
+def incomplete_beta(a, b, x):
+    """Regularized incomplete beta function I_x(a, b), continued fraction evaluated with Lentz's method"""
+    if x <= 0:
+        return 0.0
+    if x >= 1:
+        return 1.0
+    # the fraction converges quickly only below the mean, use the symmetry above it
+    if x > (a + 1) / (a + b + 2):
+        return 1 - incomplete_beta(b, a, 1 - x)
+    tiny = 1e-300
+    front = math.exp(math.lgamma(a + b) - math.lgamma(a) - math.lgamma(b) + a * math.log(x) + b * math.log1p(-x)) / a
+    c = 1.0
+    d = 1 - (a + b) * x / (a + 1)
+    d = 1 / (tiny if abs(d) < tiny else d)
+    h = d
+    for m in range(1, 301):
+        for numerator in (m * (b - m) * x / ((a + 2 * m - 1) * (a + 2 * m)),
+                          -(a + m) * (a + b + m) * x / ((a + 2 * m) * (a + 2 * m + 1))):
+            d = 1 + numerator * d
+            d = 1 / (tiny if abs(d) < tiny else d)
+            c = 1 + numerator / c
+            if abs(c) < tiny:
+                c = tiny
+            h *= c * d
+        if abs(c * d - 1) < 1e-15:
+            break
+    return front * h
+
+def t_quantile(p, dof):
+    """Quantile of Student's t distribution, the same method as student_t_quantile() in src/utils/running_stats.h"""
+    q = max(p, 1 - p)
+    v = float(dof)
+    if dof == 1:
+        t = math.tan(math.pi * (q - 0.5))
+    elif dof == 2:
+        t = (2 * q - 1) / math.sqrt(2 * q * (1 - q))
+    else:
+        # Newton's method on the CDF from 0, which is concave there so it converges monotonically
+        log_density = math.lgamma((v + 1) / 2) - math.lgamma(v / 2) - 0.5 * math.log(v * math.pi)
+        t = 0.0
+        for _ in range(100):
+            cdf = 1 - 0.5 * incomplete_beta(v / 2, 0.5, v / (v + t * t))
+            pdf = math.exp(log_density - (v + 1) / 2 * math.log1p(t * t / v))
+            step = (cdf - q) / pdf
+            t -= step
+            if abs(step) < 1e-12 * max(1.0, t):
+                break
+    return t if p >= 0.5 else -t
+
+class RunningStats:
+    """Welford's count, mean and variance, plus min and max"""
+
+    __slots__ = ("count", "mean", "m2", "min", "max")
+
+    def __init__(self):
+        self.count = 0
+        self.mean = 0.0
+        self.m2 = 0.0
+        self.min = math.inf
+        self.max = -math.inf
+
+    def add(self, value):
+        self.count += 1
+        delta = value - self.mean
+        self.mean += delta / self.count
+        self.m2 += delta * (value - self.mean)
+        self.min = min(self.min, value)
+        self.max = max(self.max, value)
+
+    def stddev(self):
+        return math.sqrt(self.m2 / (self.count - 1)) if self.count > 1 else math.nan
+
+    def half_width(self, confidence):
+        if self.count < 2:
+            return math.nan
+        return t_quantile((1 + confidence) / 2, self.count - 1) * self.stddev() / math.sqrt(self.count)
+
+def parse_number(text):
+    # OMNeT++ writes inf, -inf and nan as such
+    return float(text)
+
+def read_runs(path):
+    """Yields (config, itervars, [(module, name, value), ...]) for each run in a .sca file"""
+    config = itervars = None
+    results = []
+    statistic = None
+    with open(path, newline="") as fp:
+        for line in fp:
+            if not line.strip() or line.startswith("#"):
+                continue
+            fields = shlex.split(line)
+            kind = fields[0]
+            if kind == "run":
+                if config is not None:
+                    yield config, itervars, results
+                config = itervars = ""
+                results = []
+                statistic = None
+            elif kind == "attr" and len(fields) >= 3 and statistic is None:
+                if fields[1] == "configname":
+                    config = fields[2]
+                elif fields[1] == "iterationvars":
+                    itervars = fields[2]
+            elif kind == "scalar":
+                statistic = None
+                results.append((fields[1], fields[2], parse_number(fields[3])))
+            elif kind in ("statistic", "histogram"):
+                statistic = (fields[1], fields[2])
+            elif kind == "field" and statistic is not None:
+                results.append((statistic[0], f"{statistic[1]}:{fields[1]}", parse_number(fields[2])))
+            elif kind in ("vector", "param", "par", "config", "itervar", "version"):
+                statistic = None
+    if config is not None:
+        yield config, itervars, results
+
+class Aggregator:
+    def __init__(self, args):
+        self.args = args
+        self.filter = re.compile(args.filter) if args.filter else None
+        self.fields = set(args.fields.split(","))
+        # (config, itervars) -> (module, name) -> RunningStats, in first seen order
+        self.cells = {}
+        self.runs = 0
+        self.seen = set()
+
+    def wanted(self, module, name):
+        if ":" in name and name.rsplit(":", 1)[1] not in self.fields:
+            return False
+        return self.filter is None or self.filter.search(f"{module}.{name}") is not None
+
+    def add_file(self, path):
+        for config, itervars, results in read_runs(path):
+            cell = self.cells.setdefault((config, itervars), {})
+            for module, name, value in results:
+                if not self.wanted(module, name) or math.isnan(value):
+                    continue
+                stats = cell.get((module, name))
+                if stats is None:
+                    stats = cell[(module, name)] = RunningStats()
+                stats.add(value)
+            self.runs += 1
+
+    def files(self):
+        """New .sca files among the inputs, in name order so the result is reproducible"""
+        found = []
+        for input in self.args.inputs:
+            if os.path.isdir(input):
+                found.extend(glob.glob(os.path.join(input, "**", "*.sca"), recursive=True))
+            elif input not in self.seen:
+                found.append(input)
+        new = [path for path in found if path not in self.seen]
+        if self.args.watch is not None:
+            # a simulation may still be writing a file, it is picked up once it has been left alone for a poll
+            settled = time.time() - self.args.watch
+            new = [path for path in new if os.path.getmtime(path) < settled]
+        new.sort()
+        self.seen.update(new)
+        return new
+
+    def write(self):
+        confidence = self.args.confidence
+        out = sys.stdout if self.args.output == "-" else open(self.args.output + ".tmp", "w", newline="")
+        writer = csv.writer(out, lineterminator="\n")
+        writer.writerow(["config", "iterationvars", "module", "name", "runs", "mean", "stddev",
+                         "ci_low", "ci_high", "ci_half_width", "min", "max"])
+        for (config, itervars), cell in self.cells.items():
+            for (module, name), stats in cell.items():
+                h = stats.half_width(confidence)
+                writer.writerow([config, itervars, module, name, stats.count, repr(stats.mean), repr(stats.stddev()),
+                                 repr(stats.mean - h), repr(stats.mean + h), repr(h), repr(stats.min), repr(stats.max)])
+        if out is not sys.stdout:
+            out.close()
+            # readers never see a half written summary
+            os.replace(self.args.output + ".tmp", self.args.output)
+
+    def run(self):
+        while True:
+            new = self.files()
+            for path in new:
+                self.add_file(path)
+            if new or self.args.watch is None:
+                print(f"{self.runs} runs in {len(self.cells)} cells", file=sys.stderr)
+                if self.args.watch is None or self.args.output != "-":
+                    self.write()
+            if self.args.watch is None:
+                return
+            time.sleep(self.args.watch)
+
+def main():
+    args = parse_args()
+    aggregator = Aggregator(args)
+    try:
+        aggregator.run()
+    except KeyboardInterrupt:
+        if args.output == "-":
+            aggregator.write()
+    except BrokenPipeError:
+        pass
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,111 @@
+#!/usr/bin/env python3
+
+"""
+Tails the shared memory live feed of a running uav_rid simulation (see
+src/rid_recorder/RidLiveFeed.h) and prints each record as NDJSON. Start the
+simulation with e.g. **.liveFeed = "/uav_rid" and run:
+
+    rid-live-tail.py /uav_rid
+
+The simulation never waits for readers. A reader that falls a whole ring
+behind reports how many records it missed and continues with the oldest
+record still available.
+"""
+
+import argparse
+import json
+import mmap
+import os
+import struct
+import sys
+import time
+
+HEADER = struct.Struct("<8sIIQ")
+HEADER_SIZE = 64
+RECORD = struct.Struct("<Qiiiiqdddddddd")
+SEQ = struct.Struct("<Q")
+KINDS = ("transmission", "reception", "fix")
+
+def parse_args():
+    p = argparse.ArgumentParser(description="Print the live feed of a uav_rid simulation as NDJSON.")
+    p.add_argument("name", help="shared memory name as given to the liveFeed parameter, e.g. /uav_rid")
+    p.add_argument("--from-start", action="store_true", help="print records still in the ring before tailing")
+    p.add_argument("--poll", type=float, default=0.01, help="seconds between polls when idle")
+    return p.parse_args()
+
+def attach(path):
+    """Maps the segment once the simulation has initialized it"""
+    while True:
+        try:
+            fd = os.open(path, os.O_RDONLY)
+            size = os.fstat(fd).st_size
+            if size >= HEADER_SIZE:
+                m = mmap.mmap(fd, size, access=mmap.ACCESS_READ)
+                inode = os.fstat(fd).st_ino
+                os.close(fd)
+                magic, record_size, capacity, _ = HEADER.unpack_from(m, 0)
+                if magic == b"RIDLIVE1":
+                    if record_size != RECORD.size:
+                        sys.exit(f"{path}: unsupported record size {record_size}")
+                    return m, capacity, inode
+                m.close()
+            else:
+                os.close(fd)
+        except FileNotFoundError:
+            pass
+        time.sleep(0.1)
+
+def to_dict(values):
+    _, kind, serial, host, count, timestamp, t, rssi, x, y, z, u, v, w = values
+    record = {"kind": KINDS[kind], "serial": serial, "timestamp": timestamp, "time": t, "x": x, "y": y, "z": z}
+    if kind == 0:
+        record["host"] = host
+    elif kind == 1:
+        record.update({"host": host, "rssi": rssi, "rx_x": u, "rx_y": v, "rx_z": w})
+    else:
+        record.update({"num_reports": count, "est_x": u, "est_y": v, "est_z": w})
+    return record
+
+def main():
+    args = parse_args()
+    path = "/dev/shm/" + args.name.lstrip("/")
+    m, capacity, inode = attach(path)
+    n = SEQ.unpack_from(m, 16)[0]
+    if args.from_start:
+        n = max(0, n - capacity)
+    idle = 0
+    while True:
+        offset = HEADER_SIZE + (n % capacity) * RECORD.size
+        seq = SEQ.unpack_from(m, offset)[0]
+        if seq == 2 * n + 2:
+            values = RECORD.unpack_from(m, offset)
+            # the writer may have lapped us while we copied
+            if SEQ.unpack_from(m, offset)[0] == seq:
+                print(json.dumps(to_dict(values)), flush=True)
+                n += 1
+                idle = 0
+                continue
+        if seq > 2 * n + 2:
+            # overwritten: skip to the oldest record that can still be complete
+            latest = SEQ.unpack_from(m, 16)[0]
+            skipped = latest - capacity + 1 - n
+            print(f"missed {skipped} records", file=sys.stderr)
+            n = latest - capacity + 1
+            continue
+        # nothing new, check now and then whether a new run replaced the segment
+        idle += 1
+        if idle % 100 == 0:
+            try:
+                if os.stat(path).st_ino != inode:
+                    m.close()
+                    m, capacity, inode = attach(path)
+                    n = 0
+            except FileNotFoundError:
+                pass
+        time.sleep(args.poll)
+
+if __name__ == "__main__":
+    try:
+        main()
+    except (KeyboardInterrupt, BrokenPipeError):
+        pass
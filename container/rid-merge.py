@@ -0,0 +1,256 @@
+#!/usr/bin/env python3
+
+import argparse
+import csv
+import gzip
+import heapq
+import io
+import json
+import os
+import shutil
+import sys
+import tempfile
+
+def parse_args():
+    p = argparse.ArgumentParser(
+        description="Merge many per-run uav_rid result files in time or serial order with bounded memory.",
+        epilog="Inputs are NDJSON (e.g. rid-vec-extract --rows) or CSV with a header row, optionally gzipped. "
+               "Each file is read as a sequence of already sorted runs, so files need not be sorted as a whole. "
+               "At most --fan-in runs are merged at once; more runs are merged in several passes through "
+               "temporary files, so any number of inputs stays within the open file limit.",
+    )
+    p.add_argument("inputs", nargs="+", help="result files")
+    p.add_argument("-o", "--output", default="-", help="output file, '-' for stdout (default), '.gz' to compress")
+    p.add_argument("--key", choices=["time", "serial"], default="time", help="merge order: time, or serial then time")
+    p.add_argument("--time-field", default="time")
+    p.add_argument("--serial-field", default="serial")
+    p.add_argument("--dedupe", action="store_true", help="drop records identical to one already written with the same key")
+    p.add_argument("--format", choices=["ndjson", "csv"], help="output format (default: that of the first input)")
+    p.add_argument("--fan-in", type=int, default=256, help="runs merged at once, keep it well below 'ulimit -n' (default: 256)")
+    p.add_argument("--tmp-dir", default=None, help="directory for intermediate files (default: the system one)")
+    args = p.parse_args()
+    if args.fan_in < 2:
+        p.error("--fan-in must be at least 2")
+    return args
+
+def open_text(path, mode="rt"):
+    if path == "-":
+        return sys.stdout if "w" in mode else sys.stdin
+    if path.endswith(".gz"):
+        return gzip.open(path, mode, newline="")
+    return open(path, mode, newline="")
+
+def input_format(path):
+    with open_text(path, "rt") as fp:
+        for line in fp:
+            if line.strip():
+                return "ndjson" if line.lstrip().startswith("{") else "csv"
+    return "ndjson"
+
+class Records:
+    """Reads the records of a file from a byte offset on, parsing lines lazily"""
+
+    def __init__(self, path, fmt, offset=None):
+        self.path = path
+        self.fmt = fmt
+        self.fp = gzip.open(path, "rb") if path.endswith(".gz") else open(path, "rb")
+        self.fieldnames = None
+        if fmt == "csv":
+            self.fieldnames = next(csv.reader([self.fp.readline().decode()]))
+        if offset is not None:
+            self.fp.seek(offset)
+
+    def __iter__(self):
+        """Yields (byte offset, record) pairs"""
+        while True:
+            offset = self.fp.tell()
+            line = self.fp.readline()
+            if not line:
+                return
+            if not line.strip():
+                continue
+            if self.fmt == "ndjson":
+                yield offset, json.loads(line)
+            else:
+                yield offset, dict(zip(self.fieldnames, next(csv.reader([line.decode()]))))
+
+    def close(self):
+        self.fp.close()
+
+class RunList:
+    """(source, offset, length) of sorted runs, spilled to a temporary file as there may be millions"""
+
+    def __init__(self, tmp_dir):
+        self.fp = tempfile.TemporaryFile("w+", dir=tmp_dir)
+        self.count = 0
+
+    def add(self, source, offset, length):
+        self.fp.write(f"{source}\t{offset}\t{length}\n")
+        self.count += 1
+
+    def __iter__(self):
+        self.fp.flush()
+        self.fp.seek(0)
+        for line in self.fp:
+            source, offset, length = line.split("\t")
+            yield int(source), int(offset), int(length)
+
+    def close(self):
+        self.fp.close()
+
+class Merger:
+    def __init__(self, args, tmp_dir):
+        self.args = args
+        self.tmp_dir = tmp_dir
+        # (path, format) of the inputs and the intermediate files, runs refer to them by position
+        self.sources = []
+        # runs of each source not merged yet, and the sources that are temporary files
+        self.pending = []
+        self.temporary = set()
+
+    def key(self, record):
+        time = float(record[self.args.time_field])
+        if self.args.key == "serial":
+            return (int(record[self.args.serial_field]), time)
+        return (time,)
+
+    def seekable(self, path):
+        """A path that can be read from any offset: gzipped inputs are decompressed once, not once per run"""
+        if not path.endswith(".gz"):
+            return path, False
+        fd, plain = tempfile.mkstemp(dir=self.tmp_dir)
+        with os.fdopen(fd, "wb") as out, gzip.open(path, "rb") as fp:
+            shutil.copyfileobj(fp, out)
+        return plain, True
+
+    def add_source(self, path, fmt, temporary):
+        self.sources.append((path, fmt))
+        self.pending.append(0)
+        if temporary:
+            self.temporary.add(len(self.sources) - 1)
+        return len(self.sources) - 1
+
+    def release(self, group):
+        """Deletes the temporary files whose runs have all been merged, so a pass needs space for one copy only"""
+        for source, _, _ in group:
+            self.pending[source] -= 1
+            if self.pending[source] == 0 and source in self.temporary:
+                os.remove(self.sources[source][0])
+                self.temporary.discard(source)
+
+    def add_runs(self, path, fmt, runs):
+        """Splits a file into sorted runs and adds them to runs"""
+        plain, temporary = self.seekable(path)
+        source = self.add_source(plain, fmt, temporary)
+        records = Records(plain, fmt)
+        start = length = 0
+        previous = None
+        num_runs = 0
+        for offset, record in records:
+            k = self.key(record)
+            if previous is not None and k < previous:
+                runs.add(source, start, length)
+                num_runs += 1
+                length = 0
+            if length == 0:
+                start = offset
+            length += 1
+            previous = k
+        records.close()
+        if length > 0:
+            runs.add(source, start, length)
+            num_runs += 1
+        self.pending[source] = num_runs
+        if num_runs == 0 and temporary:
+            os.remove(plain)
+            self.temporary.discard(source)
+        if num_runs > 1:
+            print(f"{path}: {num_runs} sorted runs", file=sys.stderr)
+
+    def stream(self, source, offset, length, tiebreak):
+        path, fmt = self.sources[source]
+        records = Records(path, fmt, offset)
+        it = iter(records)
+        for _ in range(length):
+            _, record = next(it)
+            # the tiebreak keeps equal keys in input order and never compares records
+            yield (self.key(record), tiebreak, record)
+        records.close()
+
+    def merged(self, group):
+        streams = [self.stream(source, offset, length, position) for position, (source, offset, length) in enumerate(group)]
+        return heapq.merge(*streams, key=lambda item: (item[0], item[1]))
+
+    def merge_group(self, group, runs):
+        """Merges consecutive runs into one intermediate run, which keeps equal keys in input order"""
+        if len(group) == 1:
+            runs.add(*group[0])
+            return
+        fd, path = tempfile.mkstemp(dir=self.tmp_dir)
+        length = 0
+        with os.fdopen(fd, "w") as out:
+            for _, _, record in self.merged(group):
+                out.write(json.dumps(record) + "\n")
+                length += 1
+        self.release(group)
+        source = self.add_source(path, "ndjson", True)
+        self.pending[source] = 1
+        runs.add(source, 0, length)
+
+    def merge(self):
+        fmts = [input_format(path) for path in self.args.inputs]
+        out_fmt = self.args.format or fmts[0]
+        runs = RunList(self.tmp_dir)
+        for path, fmt in zip(self.args.inputs, fmts):
+            self.add_runs(path, fmt, runs)
+
+        # every pass divides the number of runs by the fan-in
+        while runs.count > self.args.fan_in:
+            print(f"merging {runs.count} runs in groups of {self.args.fan_in}", file=sys.stderr)
+            next_runs = RunList(self.tmp_dir)
+            group = []
+            for run in runs:
+                group.append(run)
+                if len(group) == self.args.fan_in:
+                    self.merge_group(group, next_runs)
+                    group = []
+            if group:
+                self.merge_group(group, next_runs)
+            runs.close()
+            runs = next_runs
+
+        with open_text(self.args.output, "wt") as out:
+            writer = None
+            seen_key = None
+            seen = set()
+            group = list(runs)
+            for k, _, record in self.merged(group):
+                if self.args.dedupe:
+                    # duplicates share the key, so only records of the current key are remembered
+                    if k != seen_key:
+                        seen_key = k
+                        seen.clear()
+                    ident = json.dumps(record, sort_keys=True)
+                    if ident in seen:
+                        continue
+                    seen.add(ident)
+                if out_fmt == "ndjson":
+                    out.write(json.dumps(record) + "\n")
+                else:
+                    if writer is None:
+                        writer = csv.DictWriter(out, fieldnames=list(record.keys()), lineterminator="\n")
+                        writer.writeheader()
+                    writer.writerow(record)
+        self.release(group)
+        runs.close()
+
+def main():
+    args = parse_args()
+    try:
+        with tempfile.TemporaryDirectory(dir=args.tmp_dir, prefix="rid-merge-") as tmp_dir:
+            Merger(args, tmp_dir).merge()
+    except BrokenPipeError:
+        pass
+
+if __name__ == "__main__":
+    main()
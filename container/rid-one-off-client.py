@@ -0,0 +1,62 @@
+#!/usr/bin/env python3
+
+import argparse
+import json
+import socket
+import sys
+
+def parse_args():
+    p = argparse.ArgumentParser(
+        description="Run a one-off simulation on rid-one-off-server.sh, taking the same arguments as rid-one-off.sh.",
+        epilog="example: %(prog)s -n 103 -t 0.1 -x 24 -y 25 -z 5 -v 1 -g 1 -H 1 -- 101,0,0,5,0,0,0 102,-500,-500,5,2,0,0",
+    )
+    p.add_argument("-s", "--socket", default="/tmp/uav_rid.sock", help="server socket path")
+    p.add_argument("-n", type=int, required=True, help="Remote ID serial number")
+    p.add_argument("-t", type=float, required=True, help="Remote ID timestamp")
+    p.add_argument("-x", type=float, required=True, help="Remote ID X position")
+    p.add_argument("-y", type=float, required=True, help="Remote ID Y position")
+    p.add_argument("-z", type=float, required=True, help="Remote ID Z position")
+    p.add_argument("-v", type=float, required=True, help="Remote ID vertical speed")
+    p.add_argument("-g", type=float, required=True, help="Remote ID horizontal (ground) speed")
+    # -h is taken by argparse
+    p.add_argument("-H", type=float, required=True, dest="h", help="Remote ID heading")
+    p.add_argument("--shutdown", action="store_true", help="stop the server after this request")
+    p.add_argument("drones", nargs="+", metavar="n,x,y,z,s,h,e", help="drone tuples, the first one transmits")
+    return p.parse_args()
+
+def parse_tuple(text):
+    fields = text.split(",")
+    if len(fields) != 7:
+        raise ValueError(f"Invalid tuple (need 7 comma-separated values): {text}")
+    return [int(fields[0])] + [float(f) for f in fields[1:]]
+
+def request(socket_path, message):
+    with socket.socket(socket.AF_UNIX, socket.SOCK_STREAM) as s:
+        s.connect(socket_path)
+        s.sendall((json.dumps(message) + "\n").encode())
+        reply = b""
+        while not reply.endswith(b"\n"):
+            chunk = s.recv(65536)
+            if not chunk:
+                break
+            reply += chunk
+    return json.loads(reply)
+
+def main():
+    args = parse_args()
+    message = {
+        "rid": {k: getattr(args, k) for k in "ntxyzvgh"},
+        "drones": [parse_tuple(t) for t in args.drones],
+    }
+    reply = request(args.socket, message)
+    if args.shutdown:
+        with socket.socket(socket.AF_UNIX, socket.SOCK_STREAM) as s:
+            s.connect(args.socket)
+            s.sendall(b'{"shutdown": true}\n')
+    if "error" in reply:
+        print(reply["error"], file=sys.stderr)
+        sys.exit(1)
+    print(json.dumps(reply))
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,53 @@
+#!/usr/bin/env bash
+
+set -e
+
+usage_text="
+Remote ID One-Off Simulation Server:
+    Keep uav_rid running and serve one-off simulations over a Unix domain socket,
+    avoiding the startup cost that rid-one-off.sh pays on every query.
+    Send requests with rid-one-off-client.py.
+
+Usage:
+    $0 [-s socket_path]
+
+Options:
+    -s      path    Unix domain socket to listen on (default /tmp/uav_rid.sock)
+"
+
+usage() {
+    echo "$usage_text" >&2
+    exit 1
+}
+
+socket_path="/tmp/uav_rid.sock"
+
+while getopts 's:' opt; do
+    case "$opt" in
+        s) socket_path=$OPTARG ;;
+        *) usage ;;
+    esac
+done
+
+. setenv
+
+exec $PROJ_DIR/out/clang-release/uav_rid -m \
+    -f "$PROJ_DIR/simulations/one_off/omnetpp.ini" \
+    -c General \
+    -l "$INET_ROOT/out/clang-release/src/libINET.so" \
+    -n "$INET_ROOT/src" \
+    -n "$INET_ROOT/src/inet/visualizer/common" \
+    -n "$INET_ROOT/examples" \
+    -n "$INET_ROOT/showcases" \
+    -n "$INET_ROOT/tests/validation" \
+    -n "$INET_ROOT/tests/networks" \
+    -n "$INET_ROOT/tutorials" \
+    -n "$PROJ_DIR/simulations" \
+    -n "$PROJ_DIR/src" \
+    -u Cmdenv \
+    --cmdenv-express-mode=true \
+    --cmdenv-status-frequency=0s \
+    --cmdenv-performance-display=false \
+    --cmdenv-event-banners=false \
+    --**.cmdenv-log-level=off \
+    --*.server.socketPath="\"$socket_path\""
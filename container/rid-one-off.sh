@@ -8,6 +8,8 @@ Remote ID One-Off Simulation:
     The options configure the Remote ID.
     The operands are given as a list of tuples, each configuring a drone.
     The first tuple given is assumed to be the transmitter.
+    Results are cached by scenario, seed and binary version, so repeating a
+    query returns the stored JSON without running the simulation.
 
 Usage:
     $0 [options] -- n,x,y,z,s,h,e [n,x,y,z,s,h,e ...]
@@ -24,7 +26,12 @@ Options:
     -v      float   Remote ID vertical speed
     -g      float   Remote ID horizontal (ground) speed
     -h      float   Remote ID heading
+    -s      int     Seed set of the simulation (default 0)
     -q              Quiet: suppress all script output except final JSON output
+    -C              No cache: always run the simulation and do not store the result
+
+Environment:
+    RID_ONE_OFF_CACHE   cache directory (default \$HOME/.cache/uav_rid/one-off)
 
 Operands:
     n       int     serial number of drone
@@ -41,7 +48,7 @@ usage() {
     exit 1
 }
 
-if ! OPTIONS=$(getopt -o 'n:,t:,x:,y:,z:,v:,g:,h:,q' -- "$@") ; then
+if ! OPTIONS=$(getopt -o 'n:,t:,x:,y:,z:,v:,g:,h:,s:,q,C' -- "$@") ; then
     echo "Failed to parse arguments with getopt" >&2
     usage
 fi
@@ -56,7 +63,9 @@ rid_z=""
 rid_v=""
 rid_g=""
 rid_h=""
+seed=0
 quiet=false
+use_cache=true
 
 while true; do
     case "$1" in
@@ -68,7 +77,9 @@ while true; do
         -v) rid_v=$2;   shift 2 ;;
         -g) rid_g=$2;   shift 2 ;;
         -h) rid_h=$2;   shift 2 ;;
+        -s) seed=$2;    shift 2 ;;
         -q) quiet=true;    shift ;;
+        -C) use_cache=false;    shift ;;
         --) shift; break ;;
         *)  echo "Unrecognized option: $1" >&2; usage ;;
     esac
@@ -107,10 +118,7 @@ fi
 host_count=$#
 tx_n=""
 rx_count=0
-tmp_dir=$(mktemp -d)
-vec_out="$tmp_dir/rid-one-off.vec"
-run_args+=" --result-dir=$tmp_dir"
-run_args+=" --output-vector-file=$vec_out"
+run_args+=" --seed-set=$seed"
 run_args+=" --*.numHosts=$host_count"
 run_args+=' --sim-time-limit=1s'
 run_args+=' --uav_rid.rid_network.BasicUav.hasVisualizer=false'
@@ -160,16 +168,77 @@ for t in "$@"; do
     host_num=$((host_num+1))
 done
 
+. setenv
+
+uav_rid_bin="$PROJ_DIR/out/clang-release/uav_rid"
+inet_lib="$INET_ROOT/out/clang-release/src/libINET.so"
+ini_file="$PROJ_DIR/simulations/basic_uav/omnetpp.ini"
+
+# normalize numbers so that e.g. 5, 5.0 and 5e0 give the same key
+normalize() {
+    awk -v RS='[ ,\n]+' '{ if ($0 ~ /^[-+0-9.eE]+$/) printf "%.17g,", $0; else printf "%s,", $0 }' <<< "$*"
+}
+
+cache_dir="${RID_ONE_OFF_CACHE:-$HOME/.cache/uav_rid/one-off}"
+
+# sha256 of a file, remembered next to the cache and keyed by path, size, mtime and inode so that
+# the large binaries are only hashed again after they have been rebuilt
+file_digest() {
+    local stamp digest_file line
+    stamp=$(stat -L -c '%s %Y %i' "$1")
+    digest_file="$cache_dir/digests/$(sha256sum <<< "$1" | cut -c1-32)"
+    if [ -f "$digest_file" ]; then
+        read -r line < "$digest_file"
+        if [ "${line% *}" = "$stamp" ]; then
+            echo "${line##* }"
+            return
+        fi
+    fi
+    line="$stamp $(sha256sum "$1" | cut -d' ' -f1)"
+    mkdir -p "$cache_dir/digests"
+    echo "$line" > "$digest_file.$$" && mv "$digest_file.$$" "$digest_file"
+    echo "${line##* }"
+}
+
+# everything that can change the output: the scenario, its seed and the binaries and models that run it
+cache_key=$(
+    {
+        echo "rid $(normalize "$rid_n $rid_t $rid_x $rid_y $rid_z $rid_v $rid_g $rid_h")"
+        for t in "$@"; do
+            echo "drone $(normalize "$t")"
+        done
+        echo "seed $seed"
+        # the script itself covers the fixed run arguments
+        for f in "$uav_rid_bin" "$inet_lib" "$ini_file" "$0" ./rid-vec-extract; do
+            file_digest "$f"
+        done
+        find "$PROJ_DIR/src" "$PROJ_DIR/simulations" -name '*.ned' -print0 | sort -z | xargs -0 cat | sha256sum | cut -d' ' -f1
+    } | sha256sum | cut -d' ' -f1
+)
+cache_file="$cache_dir/${cache_key:0:2}/$cache_key.json"
+
+if [ "$use_cache" = true ] && [ -f "$cache_file" ]; then
+    if [ "$quiet" = false ]; then
+        echo "Cache hit: $cache_file"
+    fi
+    cat "$cache_file" >&3
+    exit 0
+fi
+
+tmp_dir=$(mktemp -d)
+trap 'rm -rf "$tmp_dir"' EXIT
+vec_out="$tmp_dir/rid-one-off.vec"
+run_args+=" --result-dir=$tmp_dir"
+run_args+=" --output-vector-file=$vec_out"
+
 if [ "$quiet" = false ]; then
     echo "Running simulation with drone $tx_n as transmitter to $rx_count receiver drones and run_args: $run_args"
 fi
 
-. setenv
-
-$PROJ_DIR/out/clang-release/uav_rid -m \
-    -f "$PROJ_DIR/simulations/basic_uav/omnetpp.ini" \
+"$uav_rid_bin" -m \
+    -f "$ini_file" \
     -c General \
-    -l "$INET_ROOT/out/clang-release/src/libINET.so" \
+    -l "$inet_lib" \
     -n "$INET_ROOT/src" \
     -n "$INET_ROOT/src/inet/visualizer/common" \
     -n "$INET_ROOT/examples" \
@@ -187,10 +256,6 @@ $PROJ_DIR/out/clang-release/uav_rid -m \
     --**.cmdenv-log-level=off \
     $run_args
 
-opp_scavetool export -F CSV-R -x columnNames=true \
-    -f 'type=~"vector" and module=~"BasicUav.host[*].wlan[0].mgmt" and (name=~"Serial Number" or name=~"Reception Power" or name=~"Reception Time")' \
-    -o results.csv "$vec_out"
-
 if [ "$quiet" = true ]; then
     # restore fds
     exec 1>&3 2>&4
@@ -198,7 +263,18 @@ if [ "$quiet" = true ]; then
     exec 3>&- 4>&-
 fi
 
-./rid-csv-extract.py results.csv \
+./rid-vec-extract \
     --host-map "${host_map[@]}" \
-    --name-pattern "Serial Number" \
-    --name-pattern "Reception Power"
+    --name "receptionSerialNumber:vector=Serial Number" \
+    --name "receptionPower:vector=Reception Power" \
+    -- "$vec_out" \
+    > "$tmp_dir/results.json"
+
+if [ "$use_cache" = true ]; then
+    # write then rename, so concurrent runs never read a partial entry
+    mkdir -p "$(dirname "$cache_file")"
+    cp "$tmp_dir/results.json" "$cache_file.$$"
+    mv "$cache_file.$$" "$cache_file"
+fi
+
+cat "$tmp_dir/results.json"
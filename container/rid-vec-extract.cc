@@ -0,0 +1,352 @@
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+//
+// Extracts Remote ID vectors from an OMNeT++ .vec file into the JSON that
+// rid-csv-extract.py produces from an opp_scavetool CSV export:
+//
+//   {"<vector name>": {"<serial>": {"times": [...], "values": [...]}}}
+//
+// The file is memory mapped. When the .vci index next to it exists, only
+// the blocks of the selected vectors are parsed, otherwise one pass over
+// the whole file is made. Numbers are copied verbatim.
+//
+// Usage:
+//   rid-vec-extract [--rows] --name NAME[=LABEL] [--name NAME[=LABEL] ...] --host-map SERIAL [SERIAL ...] -- FILE.vec
+//
+// --rows prints one JSON object per sample instead (NDJSON):
+//   {"name": "...", "serial": ..., "time": "...", "value": "..."}
+//
+// --name NAME=LABEL selects the vector NAME but reports it as LABEL, e.g.
+// "receptionPower:vector=Reception Power".
+//
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+struct MappedFile
+{
+    const char *data = nullptr;
+    size_t size = 0;
+
+    explicit MappedFile(const std::string& path) {
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+            throw std::runtime_error("cannot open " + path);
+        struct stat st;
+        if (fstat(fd, &st) < 0) {
+            close(fd);
+            throw std::runtime_error("cannot stat " + path);
+        }
+        size = st.st_size;
+        if (size > 0) {
+            void *p = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (p == MAP_FAILED) {
+                close(fd);
+                throw std::runtime_error("cannot map " + path);
+            }
+            madvise(p, size, MADV_SEQUENTIAL);
+            data = static_cast<const char *>(p);
+        }
+        close(fd);
+    }
+
+    ~MappedFile() {
+        if (data != nullptr)
+            munmap(const_cast<char *>(data), size);
+    }
+};
+
+// Splits on tabs and spaces, keeping "quoted strings" together
+static std::vector<std::string_view> tokenize(std::string_view line)
+{
+    std::vector<std::string_view> tokens;
+    size_t i = 0;
+    while (i < line.size()) {
+        while (i < line.size() && (line[i] == ' ' || line[i] == '\t' || line[i] == '\r'))
+            i++;
+        if (i >= line.size())
+            break;
+        size_t start = i;
+        if (line[i] == '"') {
+            i++;
+            while (i < line.size() && line[i] != '"')
+                i += line[i] == '\\' ? 2 : 1;
+            i++;
+        }
+        else {
+            while (i < line.size() && line[i] != ' ' && line[i] != '\t' && line[i] != '\r')
+                i++;
+        }
+        tokens.push_back(line.substr(start, std::min(i, line.size()) - start));
+    }
+    return tokens;
+}
+
+static std::string unquote(std::string_view s)
+{
+    if (s.size() >= 2 && s.front() == '"' && s.back() == '"')
+        s = s.substr(1, s.size() - 2);
+    std::string result;
+    for (size_t i = 0; i < s.size(); i++) {
+        if (s[i] == '\\' && i + 1 < s.size())
+            i++;
+        result += s[i];
+    }
+    return result;
+}
+
+static std::string jsonQuote(std::string_view s)
+{
+    std::string result = "\"";
+    for (char c : s) {
+        if (c == '"' || c == '\\')
+            result += '\\';
+        result += c;
+    }
+    return result + "\"";
+}
+
+// Calls f(line) for each line in [begin, end)
+template <typename F>
+static void forEachLine(const char *begin, const char *end, F f)
+{
+    while (begin < end) {
+        const char *newline = static_cast<const char *>(memchr(begin, '\n', end - begin));
+        const char *lineEnd = newline ? newline : end;
+        f(std::string_view(begin, lineEnd - begin));
+        begin = lineEnd + 1;
+    }
+}
+
+struct Vector
+{
+    std::string name;
+    int hostIndex;
+    int timeColumn = -1;
+    int valueColumn = -1;
+    std::vector<std::string_view> times;
+    std::vector<std::string_view> values;
+};
+
+class Extractor
+{
+  protected:
+    std::vector<std::string> names;
+    std::map<long, Vector> vectors; // selected vectors by id
+
+  public:
+    explicit Extractor(const std::vector<std::string>& names) : names(names) {}
+
+    // "vector <id> <module> <name> [<columns>]" declarations from .vec or .vci
+    void declare(const std::vector<std::string_view>& tokens) {
+        if (tokens.size() < 4)
+            return;
+        std::string module = unquote(tokens[2]);
+        std::string name = unquote(tokens[3]);
+        bool selected = false;
+        for (auto& n : names)
+            selected = selected || n == name;
+        // like the scavetool filter of rid-one-off.sh: module=~"*.host[*].wlan[0].mgmt"
+        const std::string suffix = ".wlan[0].mgmt";
+        size_t host = module.find("host[");
+        if (!selected || host == std::string::npos || module.size() < suffix.size() || module.compare(module.size() - suffix.size(), suffix.size(), suffix) != 0)
+            return;
+        Vector vector;
+        vector.name = name;
+        vector.hostIndex = atoi(module.c_str() + host + 5);
+        std::string columns = tokens.size() >= 5 ? std::string(tokens[4]) : "TV";
+        for (size_t i = 0; i < columns.size(); i++) {
+            if (columns[i] == 'T')
+                vector.timeColumn = i;
+            else if (columns[i] == 'V')
+                vector.valueColumn = i;
+        }
+        if (vector.timeColumn < 0 || vector.valueColumn < 0)
+            throw std::runtime_error("unsupported vector columns " + columns);
+        vectors[strtol(std::string(tokens[1]).c_str(), nullptr, 10)] = vector;
+    }
+
+    // "<id> <columns...>" data lines
+    void data(std::string_view line) {
+        if (line.empty() || line[0] < '0' || line[0] > '9')
+            return;
+        char *end;
+        long id = strtol(line.data(), &end, 10);
+        auto it = vectors.find(id);
+        if (it == vectors.end())
+            return;
+        Vector& vector = it->second;
+        // columns follow the id, separated by tabs
+        std::string_view rest = line.substr(end - line.data());
+        int column = -1;
+        size_t i = 0;
+        while (i < rest.size()) {
+            while (i < rest.size() && (rest[i] == '\t' || rest[i] == ' '))
+                i++;
+            size_t start = i;
+            while (i < rest.size() && rest[i] != '\t' && rest[i] != ' ' && rest[i] != '\r')
+                i++;
+            if (i == start)
+                break;
+            column++;
+            if (column == vector.timeColumn)
+                vector.times.push_back(rest.substr(start, i - start));
+            else if (column == vector.valueColumn)
+                vector.values.push_back(rest.substr(start, i - start));
+        }
+    }
+
+    bool hasVectors() const { return !vectors.empty(); }
+    const std::map<long, Vector>& getVectors() const { return vectors; }
+
+    void scan(const MappedFile& vec) {
+        forEachLine(vec.data, vec.data + vec.size, [&] (std::string_view line) {
+            if (line.compare(0, 7, "vector ") == 0)
+                declare(tokenize(line));
+            else
+                data(line);
+        });
+    }
+
+    // returns false if the index cannot be used
+    bool scanIndexed(const MappedFile& vec, const MappedFile& vci) {
+        struct Block { size_t offset, length; };
+        std::vector<Block> blocks;
+        bool ok = true;
+        forEachLine(vci.data, vci.data + vci.size, [&] (std::string_view line) {
+            if (line.compare(0, 7, "vector ") == 0)
+                declare(tokenize(line));
+            else if (!line.empty() && line[0] >= '0' && line[0] <= '9') {
+                auto tokens = tokenize(line);
+                if (tokens.size() < 3) {
+                    ok = false;
+                    return;
+                }
+                long id = strtol(std::string(tokens[0]).c_str(), nullptr, 10);
+                if (vectors.count(id))
+                    blocks.push_back({strtoull(std::string(tokens[1]).c_str(), nullptr, 10), strtoull(std::string(tokens[2]).c_str(), nullptr, 10)});
+            }
+        });
+        for (auto& block : blocks)
+            ok = ok && block.offset + block.length <= vec.size;
+        if (!ok) {
+            vectors.clear();
+            return false;
+        }
+        for (auto& block : blocks)
+            forEachLine(vec.data + block.offset, vec.data + block.offset + block.length, [&] (std::string_view line) { data(line); });
+        return true;
+    }
+};
+
+static void usage(const char *argv0)
+{
+    fprintf(stderr, "Usage: %s [--rows] --name NAME[=LABEL] [--name NAME[=LABEL] ...] --host-map SERIAL [SERIAL ...] -- FILE.vec\n", argv0);
+    exit(1);
+}
+
+int main(int argc, char **argv)
+{
+    std::vector<std::string> names;
+    std::map<std::string, std::string> labels;
+    std::vector<std::string> hostMap;
+    std::string path;
+    bool rows = false;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--rows")
+            rows = true;
+        else if (arg == "--name" && i + 1 < argc) {
+            std::string name = argv[++i];
+            size_t equals = name.find('=');
+            std::string label = equals != std::string::npos ? name.substr(equals + 1) : name;
+            name = name.substr(0, equals);
+            names.push_back(name);
+            labels[name] = label;
+        }
+        else if (arg == "--host-map") {
+            while (i + 1 < argc && argv[i + 1][0] != '-')
+                hostMap.push_back(argv[++i]);
+        }
+        else if (arg == "--" && i + 1 < argc)
+            path = argv[++i];
+        else if (arg[0] != '-' && path.empty())
+            path = arg;
+        else
+            usage(argv[0]);
+    }
+    if (names.empty() || path.empty())
+        usage(argv[0]);
+
+    try {
+        MappedFile vec(path);
+        Extractor extractor(names);
+        std::string indexPath = path.substr(0, path.size() - (path.size() >= 4 && path.compare(path.size() - 4, 4, ".vec") == 0 ? 4 : 0)) + ".vci";
+        bool indexed = false;
+        if (access(indexPath.c_str(), R_OK) == 0) {
+            MappedFile vci(indexPath);
+            indexed = extractor.scanIndexed(vec, vci);
+        }
+        if (!indexed)
+            extractor.scan(vec);
+
+        // like rid-csv-extract.py: no output data at all when nobody received anything
+        std::map<std::string, std::vector<const Vector *>> byName;
+        for (auto& [id, vector] : extractor.getVectors()) {
+            if ((size_t)vector.hostIndex >= hostMap.size())
+                throw std::runtime_error("no serial number for host[" + std::to_string(vector.hostIndex) + "] in --host-map");
+            byName[labels[vector.name]].push_back(&vector);
+        }
+        if (!byName.empty()) {
+            for (auto& name : names)
+                if (!byName.count(labels[name]))
+                    throw std::runtime_error("No time series data with name '" + name + "'");
+        }
+
+        std::string out;
+        if (rows) {
+            for (auto& [name, vectors] : byName)
+                for (auto vector : vectors)
+                    for (size_t i = 0; i < vector->times.size(); i++)
+                        out += "{\"name\": " + jsonQuote(name) + ", \"serial\": " + hostMap[vector->hostIndex]
+                             + ", \"time\": " + jsonQuote(vector->times[i]) + ", \"value\": " + jsonQuote(vector->values[i]) + "}\n";
+        }
+        else {
+            out = "{";
+            bool firstName = true;
+            for (auto& [name, vectors] : byName) {
+                out += std::string(firstName ? "" : ", ") + jsonQuote(name) + ": {";
+                firstName = false;
+                bool firstVector = true;
+                for (auto vector : vectors) {
+                    out += std::string(firstVector ? "" : ", ") + jsonQuote(hostMap[vector->hostIndex]) + ": {\"times\": [";
+                    firstVector = false;
+                    for (size_t i = 0; i < vector->times.size(); i++)
+                        out += (i ? ", " : "") + jsonQuote(vector->times[i]);
+                    out += "], \"values\": [";
+                    for (size_t i = 0; i < vector->values.size(); i++)
+                        out += (i ? ", " : "") + jsonQuote(vector->values[i]);
+                    out += "]}";
+                }
+                out += "}";
+            }
+            out += "}\n";
+        }
+        fwrite(out.data(), 1, out.size(), stdout);
+    }
+    catch (std::exception& e) {
+        fprintf(stderr, "%s: %s\n", argv[0], e.what());
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,109 @@
+#!/usr/bin/env python3
+
+"""
+Reader for the .ridev files of RidEventLog and their .ridevx time index
+(layout in src/rid_recorder/RidEventLogRecord.h).
+
+    from rid_event_log import RidEventLog
+    with RidEventLog("results/rid.ridev") as log:
+        for record in log.window(10.0, 20.0, kind="fix"):
+            print(record["id"], [cause["kind"] for cause in log.trace(record["id"])])
+
+As a script it prints the matching records as NDJSON.
+"""
+
+import argparse
+import bisect
+import json
+import mmap
+import os
+import struct
+import sys
+
+RECORD = struct.Struct("<iiiiqqqddddd")
+FIELDS = ("kind", "serial", "host", "count", "event", "cause", "timestamp", "time", "rssi", "x", "y", "z")
+KINDS = ("sent", "decoded", "report", "fix")
+FILE_HEADER = struct.Struct("<8sII")
+INDEX_HEADER = struct.Struct("<8sQ")
+INDEX_ENTRY = struct.Struct("<dQ")
+
+class RidEventLog:
+    def __init__(self, path, index_path=None):
+        self.path = path
+        self.index_path = index_path or os.path.splitext(path)[0] + ".ridevx"
+        self.fp = open(path, "rb")
+        self.map = mmap.mmap(self.fp.fileno(), 0, access=mmap.ACCESS_READ)
+        magic, record_size, _ = FILE_HEADER.unpack_from(self.map, 0)
+        if magic != b"RIDEV1\0\0" or record_size != RECORD.size:
+            raise ValueError(f"{path} is not a RidEventLog file of this version")
+        self.count = (len(self.map) - FILE_HEADER.size) // RECORD.size
+        self.times, self.starts = self._read_index()
+
+    def _read_index(self):
+        """times and first records of the index entries, both ascending"""
+        with open(self.index_path, "rb") as fp:
+            data = fp.read()
+        magic, num_entries = INDEX_HEADER.unpack_from(data, 0)
+        if magic != b"RIDEVX1\0":
+            raise ValueError(f"{self.index_path} is not a RidEventLog index")
+        entries = [INDEX_ENTRY.unpack_from(data, INDEX_HEADER.size + i * INDEX_ENTRY.size) for i in range(num_entries)]
+        return [e[0] for e in entries], [e[1] for e in entries]
+
+    def __len__(self):
+        return self.count
+
+    def __getitem__(self, id):
+        if not 0 <= id < self.count:
+            raise IndexError(id)
+        record = dict(zip(FIELDS, RECORD.unpack_from(self.map, FILE_HEADER.size + id * RECORD.size)))
+        record["id"] = id
+        record["kind"] = KINDS[record["kind"]]
+        return record
+
+    def window(self, t1=float("-inf"), t2=float("inf"), kind=None, serial=None):
+        """Records with t1 <= time <= t2 in file order, starting at the last index entry before t1"""
+        entry = bisect.bisect_left(self.times, t1) - 1
+        id = self.starts[entry] if entry >= 0 else 0
+        while id < self.count:
+            record = self[id]
+            id += 1
+            if record["time"] > t2:
+                return
+            if record["time"] < t1:
+                continue
+            if (kind is None or record["kind"] == kind) and (serial is None or record["serial"] == serial):
+                yield record
+
+    def trace(self, id):
+        """The record and its causes, most recent first"""
+        while id >= 0:
+            record = self[id]
+            yield record
+            id = record["cause"]
+
+    def close(self):
+        self.map.close()
+        self.fp.close()
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *exc):
+        self.close()
+
+def main():
+    p = argparse.ArgumentParser(description="Print records of a RidEventLog file as NDJSON.")
+    p.add_argument("log", help=".ridev file, the .ridevx index is expected next to it")
+    p.add_argument("--from", dest="t1", type=float, default=float("-inf"), help="start time in seconds")
+    p.add_argument("--to", dest="t2", type=float, default=float("inf"), help="end time in seconds")
+    p.add_argument("--kind", choices=KINDS)
+    p.add_argument("--serial", type=int)
+    p.add_argument("--trace", type=int, metavar="ID", help="print the record with this id and the chain of its causes")
+    args = p.parse_args()
+    with RidEventLog(args.log) as log:
+        records = log.trace(args.trace) if args.trace is not None else log.window(args.t1, args.t2, args.kind, args.serial)
+        for record in records:
+            sys.stdout.write(json.dumps(record) + "\n")
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,102 @@
+#!/usr/bin/env python3
+
+"""
+Reader for the .ridlog files of RidLogRecorder and their .ridx index
+(layout in src/rid_recorder/RidLogRecord.h).
+
+    from rid_log import RidLog
+    with RidLog("results/rid.ridlog") as log:
+        for record in log.query(serial=103, t1=10.0, t2=20.0):
+            print(record["time"], record["rssi"])
+
+As a script it prints the matching records as NDJSON.
+"""
+
+import argparse
+import json
+import mmap
+import os
+import struct
+import sys
+
+RECORD = struct.Struct("<iiiiqdddddddd")
+FIELDS = ("kind", "serial", "host", "reserved", "timestamp", "time", "rssi", "x", "y", "z", "rx_x", "rx_y", "rx_z")
+KINDS = ("transmission", "reception")
+FILE_HEADER = struct.Struct("<8sII")
+INDEX_HEADER = struct.Struct("<8sII")
+INDEX_SERIAL = struct.Struct("<iI")
+INDEX_BLOCK = struct.Struct("<QIIdd")
+
+class RidLog:
+    def __init__(self, path, index_path=None):
+        self.path = path
+        self.index_path = index_path or os.path.splitext(path)[0] + ".ridx"
+        self.fp = open(path, "rb")
+        self.map = mmap.mmap(self.fp.fileno(), 0, access=mmap.ACCESS_READ)
+        magic, record_size, _ = FILE_HEADER.unpack_from(self.map, 0)
+        if magic != b"RIDLOG1\0" or record_size != RECORD.size:
+            raise ValueError(f"{path} is not a RidLogRecorder file of this version")
+        self.index = self._read_index()
+
+    def _read_index(self):
+        """serial -> list of (offset, count, min time, max time)"""
+        with open(self.index_path, "rb") as fp:
+            data = fp.read()
+        magic, num_serials, _ = INDEX_HEADER.unpack_from(data, 0)
+        if magic != b"RIDX1\0\0\0":
+            raise ValueError(f"{self.index_path} is not a RidLogRecorder index")
+        index = {}
+        pos = INDEX_HEADER.size
+        for _ in range(num_serials):
+            serial, num_blocks = INDEX_SERIAL.unpack_from(data, pos)
+            pos += INDEX_SERIAL.size
+            blocks = []
+            for _ in range(num_blocks):
+                offset, count, _, t_min, t_max = INDEX_BLOCK.unpack_from(data, pos)
+                pos += INDEX_BLOCK.size
+                blocks.append((offset, count, t_min, t_max))
+            index[serial] = blocks
+        return index
+
+    def serials(self):
+        return sorted(self.index)
+
+    def query(self, serial, t1=float("-inf"), t2=float("inf"), kind=None):
+        """Records of one serial number with t1 <= time <= t2 in file order, reading only overlapping blocks"""
+        for offset, count, t_min, t_max in self.index.get(serial, ()):
+            if t_max < t1 or t_min > t2:
+                continue
+            for values in RECORD.iter_unpack(self.map[offset:offset + count * RECORD.size]):
+                record = dict(zip(FIELDS, values))
+                if t1 <= record["time"] <= t2 and (kind is None or KINDS[record["kind"]] == kind):
+                    del record["reserved"]
+                    record["kind"] = KINDS[record["kind"]]
+                    yield record
+
+    def close(self):
+        self.map.close()
+        self.fp.close()
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *exc):
+        self.close()
+
+def main():
+    p = argparse.ArgumentParser(description="Print records of one drone from a RidLogRecorder file as NDJSON.")
+    p.add_argument("log", help=".ridlog file, the .ridx index is expected next to it")
+    p.add_argument("serial", type=int, nargs="?", help="serial number, omit to list the serial numbers")
+    p.add_argument("--from", dest="t1", type=float, default=float("-inf"), help="start time in seconds")
+    p.add_argument("--to", dest="t2", type=float, default=float("inf"), help="end time in seconds")
+    p.add_argument("--kind", choices=KINDS)
+    args = p.parse_args()
+    with RidLog(args.log) as log:
+        if args.serial is None:
+            print("\n".join(str(s) for s in log.serials()))
+            return
+        for record in log.query(args.serial, args.t1, args.t2, args.kind):
+            sys.stdout.write(json.dumps(record) + "\n")
+
+if __name__ == "__main__":
+    main()
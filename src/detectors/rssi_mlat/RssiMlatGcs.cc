@@ -5,19 +5,36 @@
 #include "RssiMlatGcs.h"
 
 #include "RssiMlatReport_m.h"
+#include "inet/mobility/contract/IMobility.h"
 #include "inet/physicallayer/wireless/common/contract/packetlevel/IRadioMedium.h"
 
+#include "utils/json.h"
 #include "utils/py_call.h"
 
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <filesystem>
 #include <sstream>
 
 using namespace inet;
 using namespace physicallayer;
 
 Define_Module(RssiMlatGcs);
+// named in the @signal declaration, so signal checks can test emitted objects against it
+Register_Abstract_Class(RssiMlatGcs::Fix);
+
+simsignal_t RssiMlatGcs::fixComputedSignal = cComponent::registerSignal("ridFixComputed");
 
 const std::string mlat_script_path = utils::proj_dir + "/src/detectors/rssi_mlat/mlat.py";
 
+RssiMlatGcs::~RssiMlatGcs()
+{
+    // reports of beacons still on the air when the simulation ended
+    deleteReports();
+    cancelAndDelete(terminateMsg);
+}
+
 void RssiMlatGcs::initialize()
 {
     // Get the radio medium module and subscribe to signal removal
@@ -26,10 +43,76 @@ void RssiMlatGcs::initialize()
         throw cRuntimeError("radioMedium not found");
     }
     radioMedium->subscribe(IRadioMedium::signalRemovedSignal, this);
+
+    std::string liveFeedName = par("liveFeed").stdstringValue();
+    if (!liveFeedName.empty()) {
+        liveFeed = RidLiveFeed::get(liveFeedName, par("liveFeedCapacity").intValue());
+    }
+
+    std::string datasetDir = par("datasetDir").stdstringValue();
+    maxAnchors = par("maxAnchors");
+    if (!datasetDir.empty()) {
+        std::filesystem::create_directories(datasetDir);
+        size_t k = maxAnchors;
+        dataset = std::make_unique<Dataset>();
+        dataset->serialNumber = std::make_unique<utils::NpyWriter<int32_t>>(datasetDir + "/serial_number.npy", std::vector<size_t>{});
+        dataset->timestamp = std::make_unique<utils::NpyWriter<int64_t>>(datasetDir + "/timestamp.npy", std::vector<size_t>{});
+        dataset->claimed = std::make_unique<utils::NpyWriter<double>>(datasetDir + "/claimed_position.npy", std::vector<size_t>{3});
+        dataset->truth = std::make_unique<utils::NpyWriter<double>>(datasetDir + "/true_position.npy", std::vector<size_t>{3});
+        dataset->anchors = std::make_unique<utils::NpyWriter<double>>(datasetDir + "/anchors.npy", std::vector<size_t>{k, 5});
+        dataset->mask = std::make_unique<utils::NpyWriter<uint8_t>>(datasetDir + "/anchor_mask.npy", std::vector<size_t>{k});
+        dataset->anchorRow.resize(k * 5);
+        dataset->maskRow.resize(k);
+    }
+
+    convergencePrecision = par("convergencePrecision");
+    convergenceConfidence = par("convergenceConfidence");
+    minConvergenceSamples = par("minConvergenceSamples");
+    maxConvergenceSamples = par("maxConvergenceSamples");
+    if (convergenceConfidence <= 0 || convergenceConfidence >= 1)
+        throw cRuntimeError("convergenceConfidence must be between 0 and 1, got %g", convergenceConfidence);
+    if (minConvergenceSamples < 2)
+        throw cRuntimeError("minConvergenceSamples must be at least 2, got %d", minConvergenceSamples);
+    terminateMsg = new cMessage("terminateMsg");
+
+    WATCH(numReportsIngested);
+    WATCH(numMessagesRejected);
+    WATCH(numGroupsSolved);
+    WATCH(numGroupsSkipped);
+    WATCH(numPendingReports);
+    WATCH(peakPendingReports);
+}
+
+void RssiMlatGcs::finish()
+{
+    // Fills in the final row counts
+    dataset.reset();
+
+    recordScalar("reports ingested", numReportsIngested);
+    recordScalar("messages rejected", numMessagesRejected);
+    recordScalar("groups solved", numGroupsSolved);
+    recordScalar("groups skipped", numGroupsSkipped);
+    recordScalar("peak pending reports", peakPendingReports);
+
+    double confidence = convergenceConfidence;
+    recordScalar("localization error mean", localizationError.getMean(), "m");
+    recordScalar("localization error stddev", localizationError.getStddev(), "m");
+    recordScalar("localization error ci half-width", localizationError.getHalfWidth(confidence), "m");
+    recordScalar("localization error samples", localizationError.getCount());
+    recordScalar("detection rate mean", detectionRate.getMean());
+    recordScalar("detection rate ci half-width", detectionRate.getHalfWidth(confidence));
+    recordScalar("detection rate samples", detectionRate.getCount());
+    recordScalar("converged", convergenceTime >= SIMTIME_ZERO);
+    if (convergenceTime >= SIMTIME_ZERO)
+        recordScalar("convergence time", convergenceTime, "s");
 }
 
 void RssiMlatGcs::handleMessage(cMessage *msg)
 {
+    if (msg == terminateMsg) {
+        endSimulation();
+        return;
+    }
     RssiMlatReport *report = dynamic_cast<RssiMlatReport*>(msg);
     if (report) {
         EV << "GCS received report from host " << report->getReceiverHostId()
@@ -39,10 +122,13 @@ void RssiMlatGcs::handleMessage(cMessage *msg)
         // Store the report grouped by (senderSerialNumber, timestamp)
         auto key = std::make_pair(report->getSenderSerialNumber(), report->getTimestamp());
         reportsByBeacon[key].push_back(report);
+        numReportsIngested++;
+        peakPendingReports = std::max(peakPendingReports, ++numPendingReports);
 
         EV << "Stored report. Total reports for this beacon: " << reportsByBeacon[key].size() << std::endl;
     } else {
         EV_WARN << "GCS received unknown message type" << std::endl;
+        numMessagesRejected++;
         delete msg;
     }
 }
@@ -57,25 +143,85 @@ void RssiMlatGcs::receiveSignal(cComponent *source, simsignal_t signalID, cObjec
         // Process all collected reports
         for (auto& entry : reportsByBeacon) {
             const auto& reports = entry.second;
+            if (dataset) {
+                writeDatasetRow(reports);
+            }
+
             if (reports.size() >= 3) {
                 EV << "Running multilateration for beacon (serial=" << entry.first.first
                    << ", timestamp=" << entry.first.second
                    << ") with " << reports.size() << " reports" << std::endl;
                 runMultilateration(reports);
+                numGroupsSolved++;
+                detectionRate.add(1);
             } else {
+                numGroupsSkipped++;
+                detectionRate.add(0);
                 EV_WARN << "Not enough reports (" << reports.size()
                         << ") for beacon (serial=" << entry.first.first
                         << ", timestamp=" << entry.first.second << ")" << std::endl;
             }
 
-            // Clean up reports
-            for (auto* report : reports) {
-                delete report;
-            }
         }
 
-        // Clear all stored reports
-        reportsByBeacon.clear();
+        deleteReports();
+
+        if (convergencePrecision > 0 || maxConvergenceSamples > 0)
+            checkConvergence();
+    }
+}
+
+void RssiMlatGcs::checkConvergence()
+{
+    if (terminateMsg->isScheduled())
+        return;
+
+    bool converged = false;
+    uint64_t samples = std::min(localizationError.getCount(), detectionRate.getCount());
+    if (convergencePrecision > 0 && samples >= (uint64_t)minConvergenceSamples) {
+        // relative half-width, NaN (e.g. no spread yet or a zero mean) never converges
+        double errorPrecision = localizationError.getHalfWidth(convergenceConfidence) / localizationError.getMean();
+        double detectionPrecision = detectionRate.getHalfWidth(convergenceConfidence) / detectionRate.getMean();
+        converged = errorPrecision <= convergencePrecision && detectionPrecision <= convergencePrecision;
+        EV_DEBUG << "Relative precision after " << samples << " samples: localization error " << errorPrecision
+                 << ", detection rate " << detectionPrecision << std::endl;
+    }
+    // the budget counts beacon groups, so it also ends runs in which too few reports ever arrive for a fix
+    uint64_t groups = detectionRate.getCount();
+    if (!converged && (maxConvergenceSamples == 0 || groups < (uint64_t)maxConvergenceSamples))
+        return;
+
+    if (converged)
+        convergenceTime = simTime();
+    EV_INFO << (converged ? "Localization statistics converged" : "Localization sample budget reached")
+            << " after " << groups << " beacon groups, ending the simulation" << std::endl;
+    // not from within the radio medium's signal, which is still in the middle of removing it
+    terminateMsg->setSchedulingPriority(SHRT_MIN);
+    scheduleAt(simTime(), terminateMsg);
+}
+
+void RssiMlatGcs::deleteReports()
+{
+    for (auto& entry : reportsByBeacon) {
+        for (auto* report : entry.second) {
+            delete report;
+        }
+    }
+    reportsByBeacon.clear();
+    numPendingReports = 0;
+}
+
+void RssiMlatGcs::accountMemory(RidMemoryUsage& usage) const
+{
+    for (const auto& entry : reportsByBeacon) {
+        usage.gcsReportBytes += RidMemoryUsage::nodeOverhead + sizeof(entry) + entry.second.capacity() * sizeof(RssiMlatReport*);
+        usage.gcsReportBytes += entry.second.size() * sizeof(RssiMlatReport);
+        usage.gcsReports += entry.second.size();
+    }
+    if (dataset) {
+        usage.recorderBufferBytes += dataset->serialNumber->getBufferBytes() + dataset->timestamp->getBufferBytes()
+            + dataset->claimed->getBufferBytes() + dataset->truth->getBufferBytes()
+            + dataset->anchors->getBufferBytes() + dataset->mask->getBufferBytes();
     }
 }
 
@@ -113,9 +259,114 @@ void RssiMlatGcs::runMultilateration(const std::vector<RssiMlatReport*>& reports
 
     EV << "Multilateration result: " << result << std::endl;
 
+    // The script prints the estimate as a JSON array [x, y, z]
+    utils::JsonValue estimate;
+    try {
+        estimate = utils::json_parse(result.substr(0, result.find_last_not_of(" \n") + 1));
+        if (estimate.size() != 3)
+            throw std::runtime_error("expected [x, y, z]");
+    }
+    catch (std::runtime_error& e) {
+        throw cRuntimeError("Unexpected multilateration result '%s': %s", result.c_str(), e.what());
+    }
+    Fix fix;
+    fix.senderSerialNumber = reports[0]->getSenderSerialNumber();
+    fix.timestamp = reports[0]->getTimestamp();
+    fix.time = simTime();
+    fix.x = estimate[0].asDouble();
+    fix.y = estimate[1].asDouble();
+    fix.z = estimate[2].asDouble();
+    fix.txPosX = reports[0]->getTxPosX();
+    fix.txPosY = reports[0]->getTxPosY();
+    fix.txPosZ = reports[0]->getTxPosZ();
+    fix.numReports = reports.size();
+    emit(fixComputedSignal, &fix);
+
+    // Spoofers are not at the claimed position, so measure against the truth where it is known
+    Coord truth(fix.txPosX, fix.txPosY, fix.txPosZ);
+    findTruePosition(fix.senderSerialNumber, truth);
+    localizationError.add(truth.distance(Coord(fix.x, fix.y, fix.z)));
+
+    if (liveFeed) {
+        RidLiveRecord record{};
+        record.kind = RIDLIVE_FIX;
+        record.serialNumber = fix.senderSerialNumber;
+        record.host = -1;
+        record.count = fix.numReports;
+        record.timestamp = fix.timestamp;
+        record.time = fix.time.dbl();
+        record.rssi = NAN;
+        record.x = fix.txPosX;
+        record.y = fix.txPosY;
+        record.z = fix.txPosZ;
+        record.u = fix.x;
+        record.v = fix.y;
+        record.w = fix.z;
+        liveFeed->publish(record);
+    }
+
     // Print actual transmitter position from first report for comparison
     EV << "Transmitted position: ("
        << reports[0]->getTxPosX() << ", "
        << reports[0]->getTxPosY() << ", "
        << reports[0]->getTxPosZ() << ")" << std::endl;
 }
+
+void RssiMlatGcs::writeDatasetRow(const std::vector<RssiMlatReport*>& reports)
+{
+    const RssiMlatReport *first = reports[0];
+    int32_t serialNumber = first->getSenderSerialNumber();
+    int64_t timestamp = first->getTimestamp();
+    double claimed[3] = {first->getTxPosX(), first->getTxPosY(), first->getTxPosZ()};
+
+    double truth[3] = {NAN, NAN, NAN};
+    Coord position;
+    if (findTruePosition(serialNumber, position)) {
+        truth[0] = position.x;
+        truth[1] = position.y;
+        truth[2] = position.z;
+    }
+
+    // Strongest reports first, the rest of the slots are zero and masked out
+    std::vector<const RssiMlatReport*> sorted(reports.begin(), reports.end());
+    std::stable_sort(sorted.begin(), sorted.end(), [] (const RssiMlatReport *a, const RssiMlatReport *b) {
+        return a->getRssi() > b->getRssi();
+    });
+    std::fill(dataset->anchorRow.begin(), dataset->anchorRow.end(), 0.0);
+    std::fill(dataset->maskRow.begin(), dataset->maskRow.end(), 0);
+    for (size_t i = 0; i < sorted.size() && i < (size_t)maxAnchors; i++) {
+        double *anchor = &dataset->anchorRow[i * 5];
+        anchor[0] = sorted[i]->getRxPosX();
+        anchor[1] = sorted[i]->getRxPosY();
+        anchor[2] = sorted[i]->getRxPosZ();
+        anchor[3] = sorted[i]->getRssi();
+        anchor[4] = sorted[i]->getRxTime().dbl();
+        dataset->maskRow[i] = 1;
+    }
+
+    dataset->serialNumber->append(&serialNumber);
+    dataset->timestamp->append(&timestamp);
+    dataset->claimed->append(claimed);
+    dataset->truth->append(truth);
+    dataset->anchors->append(dataset->anchorRow.data());
+    dataset->mask->append(dataset->maskRow.data());
+}
+
+bool RssiMlatGcs::findTruePosition(int serialNumber, Coord& position)
+{
+    // Actual position of the transmitter, which has not moved noticeably since sending
+    if (mobilityBySerialNumber.empty()) {
+        // no network at all when the module is benchmarked on its own
+        cModule *network = getSimulation()->getSystemModule();
+        for (int i = 0; network != nullptr && i < network->getSubmoduleVectorSize("host"); i++) {
+            cModule *host = network->getSubmodule("host", i);
+            if (host != nullptr)
+                mobilityBySerialNumber[host->getModuleByPath(".wlan[0].mgmt")->par("serialNumber").intValue()] = host->getSubmodule("mobility");
+        }
+    }
+    auto it = mobilityBySerialNumber.find(serialNumber);
+    if (it == mobilityBySerialNumber.end())
+        return false;
+    position = check_and_cast<IMobility*>(it->second)->getCurrentPosition();
+    return true;
+}
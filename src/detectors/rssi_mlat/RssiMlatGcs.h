@@ -7,14 +7,36 @@
 
 #include <omnetpp.h>
 #include <map>
+#include <memory>
 #include <vector>
 
+#include "inet/common/geometry/common/Coord.h"
+
+#include "rid_recorder/RidLiveFeed.h"
+#include "rid_recorder/RidMemoryAccounting.h"
+#include "utils/npy_writer.h"
+#include "utils/running_stats.h"
+
 using namespace omnetpp;
 
 class RssiMlatReport;
 
-class RssiMlatGcs : public cSimpleModule, public cListener
+class RssiMlatGcs : public cSimpleModule, public cListener, public IRidMemoryAccounting
 {
+  public:
+    // Transmitter position estimated from the reports about one beacon, emitted with fixComputedSignal
+    struct Fix : public cObject {
+        int senderSerialNumber;
+        int64_t timestamp;
+        simtime_t time;
+        double x, y, z;       // estimated position
+        double txPosX, txPosY, txPosZ; // position claimed in the beacon
+        int numReports;
+    };
+
+    /** emitted with every Fix as it is computed */
+    static simsignal_t fixComputedSignal;
+
   protected:
     // Map to store reports: key = (senderSerialNumber, timestamp), value = vector of reports
     std::map<std::pair<int, int64_t>, std::vector<RssiMlatReport*>> reportsByBeacon;
@@ -22,12 +44,68 @@ class RssiMlatGcs : public cSimpleModule, public cListener
     // Radio medium module
     cModule *radioMedium;
 
+    // Dataset of beacon groups, one row per beacon in each file
+    struct Dataset {
+        std::unique_ptr<utils::NpyWriter<int32_t>> serialNumber;  // (N,)
+        std::unique_ptr<utils::NpyWriter<int64_t>> timestamp;     // (N,)
+        std::unique_ptr<utils::NpyWriter<double>> claimed;        // (N, 3) position in the beacon
+        std::unique_ptr<utils::NpyWriter<double>> truth;          // (N, 3) actual transmitter position
+        std::unique_ptr<utils::NpyWriter<double>> anchors;        // (N, K, 5) rx x, y, z, RSSI, rx time
+        std::unique_ptr<utils::NpyWriter<uint8_t>> mask;          // (N, K) 1 for used anchor slots
+        std::vector<double> anchorRow;
+        std::vector<uint8_t> maskRow;
+    };
+    std::unique_ptr<Dataset> dataset;
+    int maxAnchors;
+
+    // Shared memory feed of fixes, if enabled
+    std::shared_ptr<RidLiveFeed> liveFeed;
+
+    // Mobility of each host by serial number, for the true transmitter positions
+    std::map<int, cModule*> mobilityBySerialNumber;
+
+    // Event counters, recorded as scalars
+    uint64_t numReportsIngested = 0;
+    uint64_t numMessagesRejected = 0;
+    uint64_t numGroupsSolved = 0;
+    uint64_t numGroupsSkipped = 0;
+    size_t numPendingReports = 0;
+    size_t peakPendingReports = 0;
+
+    // Convergence of the localization error and detection rate, ends the run early once precise enough
+    double convergencePrecision;
+    double convergenceConfidence;
+    int minConvergenceSamples;
+    int maxConvergenceSamples;
+    utils::RunningStats localizationError;  // distance of each fix from the true transmitter position
+    utils::RunningStats detectionRate;      // 1 for every solved beacon group, 0 for every skipped one
+    simtime_t convergenceTime = -1;
+    cMessage *terminateMsg = nullptr;
+
     virtual void initialize() override;
+    virtual void finish() override;
     virtual void handleMessage(cMessage *msg) override;
     virtual void receiveSignal(cComponent *source, simsignal_t signalID, cObject *obj, cObject *details) override;
 
+    // Helper method to delete all stored reports
+    void deleteReports();
+
     // Helper method to call multilateration script
     void runMultilateration(const std::vector<RssiMlatReport*>& reports);
+
+    // Helper method to append a beacon group to the dataset
+    void writeDatasetRow(const std::vector<RssiMlatReport*>& reports);
+
+    // Helper method to look up where the host with the serial number actually is
+    bool findTruePosition(int serialNumber, inet::Coord& position);
+
+    // Helper method to end the run once both confidence intervals are narrow enough or the budget is spent
+    void checkConvergence();
+
+  public:
+    virtual ~RssiMlatGcs();
+
+    virtual void accountMemory(RidMemoryUsage& usage) const override;
 };
 
 #endif
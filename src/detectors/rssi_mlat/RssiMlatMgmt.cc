@@ -16,6 +16,14 @@ using namespace physicallayer;
 
 Define_Module(RssiMlatMgmt);
 
+simsignal_t RssiMlatMgmt::reportSentSignal = cComponent::registerSignal("ridReportSent");
+
+void RssiMlatMgmt::finish()
+{
+    RidBeaconMgmt::finish();
+    recordScalar("reports sent", numReportsSent);
+}
+
 void RssiMlatMgmt::hookRidMsg(Packet *packet, const Ptr<const RidBeaconFrame>& beaconBody, double rssiDbm)
 {
     // Find the GCS module
@@ -51,7 +59,12 @@ void RssiMlatMgmt::hookRidMsg(Packet *packet, const Ptr<const RidBeaconFrame>& b
     // Use the passed RSSI value
     report->setRssi(rssiDbm);
 
+    auto signalTimeInd = packet->findTag<SignalTimeInd>();
+    report->setRxTime(signalTimeInd != nullptr ? signalTimeInd->getStartTime() : simTime());
+
     // Send to GCS
+    emit(reportSentSignal, report);
     sendDirect(report, gcs, "directIn");
+    numReportsSent++;
 }
 
@@ -12,7 +12,15 @@ using namespace inet::ieee80211;
 
 class RssiMlatMgmt : public RidBeaconMgmt
 {
+  public:
+    /** emitted with every RssiMlatReport sent to the GCS */
+    static simsignal_t reportSentSignal;
+
+  protected:
+    uint64_t numReportsSent = 0;
+
   protected:
+    virtual void finish() override;
     virtual void hookRidMsg(Packet *packet, const Ptr<const RidBeaconFrame>& beaconBody, double rssiDbm) override;
 };
 
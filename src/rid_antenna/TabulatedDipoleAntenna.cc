@@ -0,0 +1,116 @@
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+//
+// Based on inet/physicallayer/wireless/common/antenna/DipoleAntenna.cc
+//
+
+#include "TabulatedDipoleAntenna.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+Define_Module(TabulatedDipoleAntenna);
+
+std::map<TabulatedDipoleAntenna::TableKey, TabulatedDipoleAntenna::CachedTable> TabulatedDipoleAntenna::tables;
+
+static Coord parseWireAxis(const char *wireAxis)
+{
+    if (!strcmp(wireAxis, "x"))
+        return Coord::X_AXIS;
+    else if (!strcmp(wireAxis, "y"))
+        return Coord::Y_AXIS;
+    else if (!strcmp(wireAxis, "z"))
+        return Coord::Z_AXIS;
+    else
+        throw cRuntimeError("Unknown wireAxis '%s', expected x, y or z", wireAxis);
+}
+
+static double dot(const Coord& a, const Coord& b)
+{
+    return a.x * b.x + a.y * b.y + a.z * b.z;
+}
+
+static Coord cross(const Coord& a, const Coord& b)
+{
+    return Coord(a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x);
+}
+
+/** the direction at the given cosine to the wire axis, on the side of the perpendicular */
+static Quaternion computeDirection(const Coord& wireAxis, const Coord& perpendicular, double cosine)
+{
+    double sine = std::sqrt(std::max(1 - cosine * cosine, 0.0));
+    Coord target(wireAxis.x * cosine + perpendicular.x * sine, wireAxis.y * cosine + perpendicular.y * sine, wireAxis.z * cosine + perpendicular.z * sine);
+    return Quaternion::rotationFromTo(Coord::X_AXIS, target);
+}
+
+/** a unit vector perpendicular to the wire axis */
+static Coord computePerpendicular(const Coord& wireAxis)
+{
+    Coord other = std::abs(wireAxis.x) < 0.5 ? Coord::X_AXIS : Coord::Y_AXIS;
+    Coord perpendicular = cross(wireAxis, other);
+    return perpendicular / perpendicular.length();
+}
+
+TabulatedDipoleAntenna::GainTable::GainTable(const IAntennaGain *reference, const Coord& wireAxis, int size) :
+    wireAxis(wireAxis), step(2.0 / (size - 1)), gains(size)
+{
+    Coord perpendicular = computePerpendicular(wireAxis);
+    for (int i = 0; i < size; i++)
+        gains[i] = reference->computeGain(computeDirection(wireAxis, perpendicular, std::min(-1 + i * step, 1.0)));
+}
+
+double TabulatedDipoleAntenna::GainTable::lookup(const Coord& direction) const
+{
+    double u = (std::min(std::max(dot(direction, wireAxis), -1.0), 1.0) + 1) / step;
+    int i = std::min((int)u, (int)gains.size() - 2);
+    return gains[i] + (gains[i + 1] - gains[i]) * (u - i);
+}
+
+double TabulatedDipoleAntenna::GainTable::computeMaxError(const IAntennaGain *reference) const
+{
+    // linear interpolation is least accurate in the middle of the entries; two perpendiculars
+    // also check that the reference really is symmetric around the wire axis
+    Coord perpendiculars[2] = {computePerpendicular(wireAxis), cross(wireAxis, computePerpendicular(wireAxis))};
+    double maxError = 0;
+    for (const Coord& perpendicular : perpendiculars) {
+        for (size_t i = 0; i < gains.size() - 1; i++) {
+            Quaternion direction = computeDirection(wireAxis, perpendicular, std::min(-1 + (i + 0.5) * step, 1.0));
+            double error = std::abs(lookup(direction.rotate(Coord::X_AXIS)) - reference->computeGain(direction));
+            maxError = std::max(maxError, error);
+        }
+    }
+    return maxError;
+}
+
+double TabulatedDipoleAntenna::AntennaGain::computeGain(const Quaternion& direction) const
+{
+    return table->lookup(direction.rotate(Coord::X_AXIS));
+}
+
+void TabulatedDipoleAntenna::initialize(int stage)
+{
+    DipoleAntenna::initialize(stage);
+
+    if (stage == INITSTAGE_LOCAL) {
+        int tableSize = par("tableSize");
+        double tolerance = par("tolerance");
+        if (tableSize < 2)
+            throw cRuntimeError("tableSize must be at least 2");
+        tabulatedGain = makeShared<AntennaGain>(getTable(tableSize, tolerance), gain->getMinGain(), gain->getMaxGain());
+    }
+}
+
+std::shared_ptr<const TabulatedDipoleAntenna::GainTable> TabulatedDipoleAntenna::getTable(int tableSize, double tolerance)
+{
+    TableKey key(par("wireAxis").stdstringValue(), m(par("length")).get(), tableSize);
+    auto it = tables.find(key);
+    if (it == tables.end()) {
+        EV_INFO << "Precomputing dipole antenna gain table" << endl;
+        auto table = std::make_shared<const GainTable>(gain.get(), parseWireAxis(par("wireAxis")), tableSize);
+        it = tables.emplace(key, CachedTable{table, table->computeMaxError(gain.get())}).first;
+    }
+    if (it->second.maxError > tolerance)
+        throw cRuntimeError("Tabulated antenna gain error %g exceeds tolerance %g, increase tableSize", it->second.maxError, tolerance);
+    return it->second.table;
+}
@@ -0,0 +1,79 @@
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+//
+// Based on inet/physicallayer/wireless/common/antenna/DipoleAntenna.h
+//
+
+#ifndef __TABULATED_DIPOLE_ANTENNA_H
+#define __TABULATED_DIPOLE_ANTENNA_H
+
+#include "inet/physicallayer/wireless/common/antenna/DipoleAntenna.h"
+
+#include <map>
+#include <memory>
+#include <tuple>
+#include <vector>
+
+using namespace inet;
+using namespace inet::physicallayer;
+
+//
+// DipoleAntenna whose gain is looked up in a table and linearly interpolated.
+// The gain of a dipole only depends on the angle between the direction and
+// the wire axis, so the table runs over the cosine of that angle, which a dot
+// product yields without any trigonometry. Tables are shared by all antennas
+// with the same wire axis, length and table size.
+//
+class TabulatedDipoleAntenna : public DipoleAntenna
+{
+  protected:
+    class GainTable
+    {
+      protected:
+        Coord wireAxis;
+        double step;
+        // gains for cosines from -1 to 1
+        std::vector<double> gains;
+
+      public:
+        GainTable(const IAntennaGain *reference, const Coord& wireAxis, int size);
+        double lookup(const Coord& direction) const;
+        double computeMaxError(const IAntennaGain *reference) const;
+    };
+
+    class AntennaGain : public IAntennaGain
+    {
+      protected:
+        std::shared_ptr<const GainTable> table;
+        double minGain;
+        double maxGain;
+
+      public:
+        AntennaGain(std::shared_ptr<const GainTable> table, double minGain, double maxGain) : table(table), minGain(minGain), maxGain(maxGain) {}
+        virtual double getMinGain() const override { return minGain; }
+        virtual double getMaxGain() const override { return maxGain; }
+        virtual double computeGain(const Quaternion& direction) const override;
+    };
+
+    // key = (wire axis, length in meters, table size)
+    typedef std::tuple<std::string, double, int> TableKey;
+    // the error against the analytic gain is kept so every user can check it against its own tolerance
+    struct CachedTable {
+        std::shared_ptr<const GainTable> table;
+        double maxError;
+    };
+    static std::map<TableKey, CachedTable> tables;
+
+    Ptr<AntennaGain> tabulatedGain;
+
+  protected:
+    virtual void initialize(int stage) override;
+
+    /** Utility function: returns the shared table for this antenna, creating and validating it if needed */
+    virtual std::shared_ptr<const GainTable> getTable(int tableSize, double tolerance);
+
+  public:
+    virtual Ptr<const IAntennaGain> getGain() const override { return tabulatedGain; }
+};
+
+#endif
@@ -11,10 +11,36 @@
 #include "inet/physicallayer/wireless/common/contract/packetlevel/SignalTag_m.h"
 #include "inet/physicallayer/wireless/ieee80211/packetlevel/Ieee80211Radio.h"
 
+#include <algorithm>
+#include <limits>
+
 using namespace physicallayer;
 
 Define_Module(RidBeaconMgmt);
 
+simsignal_t RidBeaconMgmt::beaconReceivedSignal = cComponent::registerSignal("ridBeaconReceived");
+simsignal_t RidBeaconMgmt::beaconSentSignal = cComponent::registerSignal("ridBeaconSent");
+simsignal_t RidBeaconMgmt::receptionPowerSignal = cComponent::registerSignal("receptionPower");
+simsignal_t RidBeaconMgmt::receptionTimeSignal = cComponent::registerSignal("receptionTime");
+simsignal_t RidBeaconMgmt::receptionTimestampSignal = cComponent::registerSignal("receptionTimestamp");
+simsignal_t RidBeaconMgmt::receptionPacketIdSignal = cComponent::registerSignal("receptionPacketId");
+simsignal_t RidBeaconMgmt::receptionSerialNumberSignal = cComponent::registerSignal("receptionSerialNumber");
+simsignal_t RidBeaconMgmt::receptionPosXSignal = cComponent::registerSignal("receptionPosX");
+simsignal_t RidBeaconMgmt::receptionPosYSignal = cComponent::registerSignal("receptionPosY");
+simsignal_t RidBeaconMgmt::receptionPosZSignal = cComponent::registerSignal("receptionPosZ");
+simsignal_t RidBeaconMgmt::receptionSpeedVerticalSignal = cComponent::registerSignal("receptionSpeedVertical");
+simsignal_t RidBeaconMgmt::receptionSpeedHorizontalSignal = cComponent::registerSignal("receptionSpeedHorizontal");
+simsignal_t RidBeaconMgmt::receptionHeadingSignal = cComponent::registerSignal("receptionHeading");
+simsignal_t RidBeaconMgmt::receptionMyPosXSignal = cComponent::registerSignal("receptionMyPosX");
+simsignal_t RidBeaconMgmt::receptionMyPosYSignal = cComponent::registerSignal("receptionMyPosY");
+simsignal_t RidBeaconMgmt::receptionMyPosZSignal = cComponent::registerSignal("receptionMyPosZ");
+simsignal_t RidBeaconMgmt::transmissionPosXSignal = cComponent::registerSignal("transmissionPosX");
+simsignal_t RidBeaconMgmt::transmissionPosYSignal = cComponent::registerSignal("transmissionPosY");
+simsignal_t RidBeaconMgmt::transmissionPosZSignal = cComponent::registerSignal("transmissionPosZ");
+simsignal_t RidBeaconMgmt::transmissionSpeedVerticalSignal = cComponent::registerSignal("transmissionSpeedVertical");
+simsignal_t RidBeaconMgmt::transmissionSpeedHorizontalSignal = cComponent::registerSignal("transmissionSpeedHorizontal");
+simsignal_t RidBeaconMgmt::transmissionHeadingSignal = cComponent::registerSignal("transmissionHeading");
+
 RidBeaconMgmt::~RidBeaconMgmt()
 {
     cancelAndDelete(beaconTimer);
@@ -33,32 +59,54 @@ void RidBeaconMgmt::initialize(int stage)
         startupJitter = par("startupJitter");
         transmitBeacon = par("transmitBeacon");
         oneOff = par("oneOff");
+        std::string liveFeedName = par("liveFeed").stdstringValue();
+        if (!liveFeedName.empty()) {
+            liveFeed = RidLiveFeed::get(liveFeedName, par("liveFeedCapacity").intValue());
+        }
+        std::string policy = par("recordingPolicy").stdstringValue();
+        if (policy == "all")
+            recordingPolicy = RECORD_ALL;
+        else if (policy == "stride")
+            recordingPolicy = RECORD_STRIDE;
+        else if (policy == "reservoir")
+            recordingPolicy = RECORD_RESERVOIR;
+        else if (policy == "distance")
+            recordingPolicy = RECORD_DISTANCE;
+        else
+            throw cRuntimeError("unknown recordingPolicy '%s'", policy.c_str());
+        recordingStride = par("recordingStride");
+        if (recordingStride < 1)
+            throw cRuntimeError("recordingStride must be at least 1");
+        reservoirSize = par("reservoirSize");
+        if (recordingPolicy == RECORD_RESERVOIR && reservoirSize < 1)
+            throw cRuntimeError("reservoirSize must be at least 1");
+        if (recordingPolicy == RECORD_RESERVOIR) {
+            // seeded from the seed set and the module path, reproducible per run and different per host
+            std::vector<uint32_t> seed;
+            // embedded runs (src/rid_embed) have no ini configuration and a single seed set
+            auto config = dynamic_cast<cConfigurationEx *>(getEnvir()->getConfig());
+            uint64_t seedSet = config != nullptr ? std::stoull(config->getVariable(CFGVAR_SEEDSET)) : 0;
+            seed.push_back((uint32_t)seedSet);
+            seed.push_back((uint32_t)(seedSet >> 32));
+            for (char c : getFullPath())
+                seed.push_back((unsigned char)c);
+            std::seed_seq sequence(seed.begin(), seed.end());
+            reservoirRng.seed(sequence);
+        }
+        distanceBands = cStringTokenizer(par("distanceBands")).asDoubleVector();
+        distanceBandStrides = cStringTokenizer(par("distanceBandStrides")).asIntVector();
+        if (recordingPolicy == RECORD_DISTANCE && distanceBandStrides.size() != distanceBands.size() + 1)
+            throw cRuntimeError("distanceBandStrides needs one more entry than distanceBands");
+        if (!std::is_sorted(distanceBands.begin(), distanceBands.end()))
+            throw cRuntimeError("distanceBands must be in increasing order");
         channelNumber = -1; // value will arrive from physical layer in receiveChangeNotification()
         WATCH(ssid);
         WATCH(channelNumber);
         WATCH(beaconInterval);
-
-        // set descriptive names for the Analysis Tool
-        recvec.power.setName("Reception Power");
-        recvec.time.setName("Reception Time");
-        recvec.timestamp.setName("Reception Timestamp");
-        recvec.packetId.setName("Packet ID");
-        recvec.serialNumber.setName("Serial Number");
-        recvec.txPosX.setName("Transmission X Coordinate");
-        recvec.txPosY.setName("Transmission Y Coordinate");
-        recvec.txPosZ.setName("Transmission Z Coordinate");
-        recvec.rxPosX.setName("Reception X Coordinate");
-        recvec.rxPosY.setName("Reception Y Coordinate");
-        recvec.rxPosZ.setName("Reception Z Coordinate");
-        recvec.txSpeedVertical.setName("Transmission Vertical Speed");
-        recvec.txSpeedHorizontal.setName("Transmission Horizontal Speed");
-        recvec.txHeading.setName("Transmission Heading");
-        recvec.rxSpeedVertical.setName("Reception Vertical Speed");
-        recvec.rxSpeedHorizontal.setName("Reception Horizontal Speed");
-        recvec.rxHeading.setName("Reception Heading");
-        recvec.rxMyPosX.setName("Reception My X Coordinate");
-        recvec.rxMyPosY.setName("Reception My Y Coordinate");
-        recvec.rxMyPosZ.setName("Reception My Z Coordinate");
+        WATCH(numBeaconsSent);
+        WATCH(numBeaconsReceived);
+        WATCH(numReceptionsRecorded);
+        WATCH(numFramesDropped);
 
         // subscribe for notifications
         cModule *radioModule = getModuleFromPar<cModule>(par("radioModule"), this);
@@ -76,6 +124,27 @@ void RidBeaconMgmt::initialize(int stage)
     }
 }
 
+void RidBeaconMgmt::finish()
+{
+    if (recordingPolicy == RECORD_RESERVOIR) {
+        // the samples of all links go out in time order, as vector recording expects
+        std::vector<const Reception *> samples;
+        for (const auto& [serial, link] : links)
+            for (const auto& reception : link.reservoir)
+                samples.push_back(&reception);
+        std::sort(samples.begin(), samples.end(), [](const Reception *a, const Reception *b) { return a->time < b->time; });
+        for (const Reception *reception : samples)
+            recordReception(*reception, true);
+        numReceptionsRecorded += samples.size();
+        links.clear();
+    }
+
+    recordScalar("beacons sent", numBeaconsSent);
+    recordScalar("beacons received", numBeaconsReceived);
+    recordScalar("receptions recorded", numReceptionsRecorded);
+    recordScalar("frames dropped", numFramesDropped);
+}
+
 void RidBeaconMgmt::handleTimer(cMessage *msg)
 {
     if (msg == beaconTimer) {
@@ -115,6 +184,8 @@ void RidBeaconMgmt::sendManagementFrame(const char *name, const Ptr<Ieee80211Mgm
     packet->addTag<MacAddressReq>()->setDestAddress(destAddr);
     packet->addTag<Ieee80211SubtypeReq>()->setSubtype(subtype);
     packet->insertAtBack(body);
+    if (subtype == ST_BEACON)
+        emit(beaconSentSignal, packet);
     sendDown(packet);
 }
 
@@ -132,25 +203,38 @@ void RidBeaconMgmt::sendBeacon()
     fillRidMsg(body);
 
     EV << "BODY: " << body << std::endl;
-    recvec.txPosX.record(body->getPosX());
-    recvec.txPosY.record(body->getPosY());
-    recvec.txPosZ.record(body->getPosZ());
-    recvec.txSpeedVertical.record(body->getSpeedVertical());
-    recvec.txSpeedHorizontal.record(body->getSpeedHorizontal());
-    recvec.txHeading.record(body->getHeading());
+    numBeaconsSent++;
+    recordTransmission(body);
+    if (liveFeed) {
+        RidLiveRecord record{};
+        record.kind = RIDLIVE_TRANSMISSION;
+        record.serialNumber = body->getSerialNumber();
+        record.host = getContainingNode(this)->getIndex();
+        record.timestamp = body->getTimestamp();
+        record.time = simTime().dbl();
+        record.rssi = record.u = record.v = record.w = NAN;
+        record.x = body->getPosX();
+        record.y = body->getPosY();
+        record.z = body->getPosZ();
+        liveFeed->publish(record);
+    }
     sendManagementFrame("Beacon", body, ST_BEACON, MacAddress::BROADCAST_ADDRESS);
 }
 
 void RidBeaconMgmt::fillRidMsg(const inet::Ptr<RidBeaconFrame> & body)
 {
-    auto currentTime = simTime();
-    body->setTimestamp(currentTime.inUnit(SimTimeUnit::SIMTIME_MS));
-    body->setSerialNumber(serialNumber);
     auto host = getContainingNode(this);
     auto mobility = check_and_cast<IMobility*>(host->getSubmodule("mobility"));
+    EV << "VELOCITY: " << mobility->getCurrentVelocity() << std::endl;
+    fillRidFields(body, serialNumber, simTime(), mobility);
+}
+
+void RidBeaconMgmt::fillRidFields(const inet::Ptr<RidBeaconFrame>& body, int serialNumber, simtime_t time, IMobility *mobility)
+{
+    body->setTimestamp(time.inUnit(SimTimeUnit::SIMTIME_MS));
+    body->setSerialNumber(serialNumber);
     auto pos = mobility->getCurrentPosition();
     auto velocity = mobility->getCurrentVelocity();
-    EV << "VELOCITY: " << velocity << std::endl;
     double posX = pos.getX();
     double posY = pos.getY();
     double posZ = pos.getZ();
@@ -170,9 +254,19 @@ void RidBeaconMgmt::fillRidMsg(const inet::Ptr<RidBeaconFrame> & body)
 
 void RidBeaconMgmt::handleBeaconFrame(Packet *packet, const Ptr<const Ieee80211MgmtHeader>& header)
 {
-    msgid_t packetId = packet->getId();
-    if (packetId >= 0) {
-        recvec.packetId.record(packetId);
+    auto beaconBody = packet->peekAtFront<RidBeaconFrame>();
+    if (beaconBody == nullptr) {
+        throw cRuntimeError("Missing RidBeaconFrame header in received Packet");
+    }
+    numBeaconsReceived++;
+
+    // our own position is only needed for recording and the live feed
+    bool recording = isRecordingReceptions();
+    cModule *host = nullptr;
+    Coord pos;
+    if (recording || liveFeed) {
+        host = getContainingNode(this);
+        pos = check_and_cast<IMobility*>(host->getSubmodule("mobility"))->getCurrentPosition();
     }
 
     double rssiDbm = 0.0;
@@ -189,42 +283,246 @@ void RidBeaconMgmt::handleBeaconFrame(Packet *packet, const Ptr<const Ieee80211M
         W receivedPower = signalPowerInd->getPower();
         // convert to dBm for more readable values
         rssiDbm = 10 * std::log10(receivedPower.get() * 1000);
-        recvec.power.record(rssiDbm);
     }
 
-    // get reception time
-    auto signalTimeInd = packet->findTag<SignalTimeInd>();
-    if (signalTimeInd != nullptr) {
-        simtime_t receptionStart = signalTimeInd->getStartTime();
-        recvec.time.record(receptionStart.dbl());
+    // decide on recording before touching any of the values to record
+    Reception *slot = nullptr;
+    double distance = recording && recordingPolicy == RECORD_DISTANCE ? pos.distance(Coord(beaconBody->getPosX(), beaconBody->getPosY(), beaconBody->getPosZ())) : 0;
+    if (recording && sampleReception(beaconBody->getSerialNumber(), distance, slot)) {
+        Reception reception;
+        reception.time = simTime();
+        msgid_t packetId = packet->getId();
+        reception.packetId = packetId >= 0 ? packetId : NAN;
+        reception.power = signalPowerInd != nullptr ? rssiDbm : NAN;
+        auto signalTimeInd = packet->findTag<SignalTimeInd>();
+        reception.receptionTime = signalTimeInd != nullptr ? signalTimeInd->getStartTime().dbl() : NAN;
+        reception.timestamp = beaconBody->getTimestamp();
+        reception.serialNumber = beaconBody->getSerialNumber();
+        reception.txPosX = beaconBody->getPosX();
+        reception.txPosY = beaconBody->getPosY();
+        reception.txPosZ = beaconBody->getPosZ();
+        reception.txSpeedVertical = beaconBody->getSpeedVertical();
+        reception.txSpeedHorizontal = beaconBody->getSpeedHorizontal();
+        reception.txHeading = beaconBody->getHeading();
+        reception.myPosX = pos.getX();
+        reception.myPosY = pos.getY();
+        reception.myPosZ = pos.getZ();
+        if (slot != nullptr)
+            *slot = reception;
+        else {
+            recordReception(reception, false);
+            numReceptionsRecorded++;
+        }
     }
 
-    auto beaconBody = packet->peekAtFront<RidBeaconFrame>();
-    if (beaconBody != nullptr) {
-        recvec.timestamp.record(beaconBody->getTimestamp());
-        recvec.serialNumber.record(beaconBody->getSerialNumber());
-        recvec.rxPosX.record(beaconBody->getPosX());
-        recvec.rxPosY.record(beaconBody->getPosY());
-        recvec.rxPosZ.record(beaconBody->getPosZ());
-        recvec.rxSpeedVertical.record(beaconBody->getSpeedVertical());
-        recvec.rxSpeedHorizontal.record(beaconBody->getSpeedHorizontal());
-        recvec.rxHeading.record(beaconBody->getHeading());
-    } else {
-        throw cRuntimeError("Missing RidBeaconFrame header in received Packet");
+    if (liveFeed) {
+        RidLiveRecord record{};
+        record.kind = RIDLIVE_RECEPTION;
+        record.serialNumber = beaconBody->getSerialNumber();
+        record.host = host->getIndex();
+        record.timestamp = beaconBody->getTimestamp();
+        record.time = simTime().dbl();
+        record.rssi = signalPowerInd != nullptr ? rssiDbm : NAN;
+        record.x = beaconBody->getPosX();
+        record.y = beaconBody->getPosY();
+        record.z = beaconBody->getPosZ();
+        record.u = pos.getX();
+        record.v = pos.getY();
+        record.w = pos.getZ();
+        liveFeed->publish(record);
     }
 
-    auto host = getContainingNode(this);
-    auto mobility = check_and_cast<IMobility*>(host->getSubmodule("mobility"));
-    auto pos = mobility->getCurrentPosition();
-    recvec.rxMyPosX.record(pos.getX());
-    recvec.rxMyPosY.record(pos.getY());
-    recvec.rxMyPosZ.record(pos.getZ());
+    // listeners see the decode before whatever a detector makes of it
+    emit(beaconReceivedSignal, packet);
 
     hookRidMsg(packet, beaconBody, rssiDbm);
 
     dropManagementFrame(packet);
 }
 
+void RidBeaconMgmt::dropUnhandledFrame(Packet *packet)
+{
+    numFramesDropped++;
+    dropManagementFrame(packet);
+}
+
+void RidBeaconMgmt::recordValue(simsignal_t signal, double value, ReplayKind kind)
+{
+    if (!mayHaveListeners(signal)) {
+        return;
+    }
+    emit(signal, value);
+    if (capturing) {
+        captured.push_back({signal, simTime(), value, kind});
+    }
+}
+
+void RidBeaconMgmt::recordValueAt(simsignal_t signal, simtime_t time, double value)
+{
+    if (!mayHaveListeners(signal)) {
+        return;
+    }
+    // result recorders take the timestamp from the value instead of the current time
+    cTimestampedValue timestampedValue(time, value);
+    emit(signal, &timestampedValue);
+}
+
+void RidBeaconMgmt::recordTransmission(const Ptr<const RidBeaconFrame>& body)
+{
+    recordValue(transmissionPosXSignal, body->getPosX(), REPLAY_CONSTANT);
+    recordValue(transmissionPosYSignal, body->getPosY(), REPLAY_CONSTANT);
+    recordValue(transmissionPosZSignal, body->getPosZ(), REPLAY_CONSTANT);
+    recordValue(transmissionSpeedVerticalSignal, body->getSpeedVertical(), REPLAY_CONSTANT);
+    recordValue(transmissionSpeedHorizontalSignal, body->getSpeedHorizontal(), REPLAY_CONSTANT);
+    recordValue(transmissionHeadingSignal, body->getHeading(), REPLAY_CONSTANT);
+}
+
+bool RidBeaconMgmt::isRecordingReceptions() const
+{
+    return mayHaveListeners(receptionPowerSignal) || mayHaveListeners(receptionTimeSignal)
+        || mayHaveListeners(receptionTimestampSignal) || mayHaveListeners(receptionPacketIdSignal)
+        || mayHaveListeners(receptionSerialNumberSignal) || mayHaveListeners(receptionPosXSignal)
+        || mayHaveListeners(receptionPosYSignal) || mayHaveListeners(receptionPosZSignal)
+        || mayHaveListeners(receptionSpeedVerticalSignal) || mayHaveListeners(receptionSpeedHorizontalSignal)
+        || mayHaveListeners(receptionHeadingSignal) || mayHaveListeners(receptionMyPosXSignal)
+        || mayHaveListeners(receptionMyPosYSignal) || mayHaveListeners(receptionMyPosZSignal);
+}
+
+uint64_t RidBeaconMgmt::drawReservoirIndex(uint64_t bound)
+{
+    // rejection sampling, unlike std::uniform_int_distribution the same on every standard library
+    uint64_t range = bound + 1;
+    if (range == 0)
+        return reservoirRng();
+    uint64_t limit = std::numeric_limits<uint64_t>::max() - std::numeric_limits<uint64_t>::max() % range;
+    uint64_t value;
+    do
+        value = reservoirRng();
+    while (value >= limit);
+    return value % range;
+}
+
+bool RidBeaconMgmt::sampleReception(int serialNumber, double distance, Reception *& slot)
+{
+    slot = nullptr;
+    if (recordingPolicy == RECORD_ALL)
+        return true;
+
+    LinkRecording& link = links[serialNumber];
+    uint64_t index = link.seen++;
+    switch (recordingPolicy) {
+        case RECORD_STRIDE:
+            return index % recordingStride == 0;
+        case RECORD_RESERVOIR:
+            // Algorithm R: the n-th reception replaces a random entry with probability R/n
+            if (index < (uint64_t)reservoirSize) {
+                link.reservoir.emplace_back();
+                slot = &link.reservoir.back();
+                return true;
+            }
+            else {
+                uint64_t j = drawReservoirIndex(index);
+                if (j >= (uint64_t)reservoirSize)
+                    return false;
+                slot = &link.reservoir[j];
+                return true;
+            }
+        case RECORD_DISTANCE: {
+            size_t band = std::upper_bound(distanceBands.begin(), distanceBands.end(), distance) - distanceBands.begin();
+            int stride = distanceBandStrides[band];
+            return stride > 0 && index % stride == 0;
+        }
+        default:
+            return true;
+    }
+}
+
+void RidBeaconMgmt::recordReception(const Reception& reception, bool deferred)
+{
+    auto record = [&](simsignal_t signal, double value, ReplayKind kind) {
+        if (std::isnan(value))
+            return;
+        if (deferred)
+            recordValueAt(signal, reception.time, value);
+        else
+            recordValue(signal, value, kind);
+    };
+    record(receptionPacketIdSignal, reception.packetId, REPLAY_NONE);
+    record(receptionPowerSignal, reception.power, REPLAY_RSSI);
+    record(receptionTimeSignal, reception.receptionTime, REPLAY_TIME);
+    record(receptionTimestampSignal, reception.timestamp, REPLAY_TIMESTAMP);
+    record(receptionSerialNumberSignal, reception.serialNumber, REPLAY_CONSTANT);
+    record(receptionPosXSignal, reception.txPosX, REPLAY_CONSTANT);
+    record(receptionPosYSignal, reception.txPosY, REPLAY_CONSTANT);
+    record(receptionPosZSignal, reception.txPosZ, REPLAY_CONSTANT);
+    record(receptionSpeedVerticalSignal, reception.txSpeedVertical, REPLAY_CONSTANT);
+    record(receptionSpeedHorizontalSignal, reception.txSpeedHorizontal, REPLAY_CONSTANT);
+    record(receptionHeadingSignal, reception.txHeading, REPLAY_CONSTANT);
+    record(receptionMyPosXSignal, reception.myPosX, REPLAY_CONSTANT);
+    record(receptionMyPosYSignal, reception.myPosY, REPLAY_CONSTANT);
+    record(receptionMyPosZSignal, reception.myPosZ, REPLAY_CONSTANT);
+}
+
+void RidBeaconMgmt::accountMemory(RidMemoryUsage& usage) const
+{
+    for (const auto& entry : links)
+        usage.hostStateBytes += RidMemoryUsage::nodeOverhead + sizeof(entry) + entry.second.reservoir.capacity() * sizeof(Reception);
+    usage.hostStateBytes += captured.capacity() * sizeof(CapturedValue);
+}
+
+void RidBeaconMgmt::startCapture()
+{
+    Enter_Method("startCapture");
+    captured.clear();
+    capturing = true;
+}
+
+void RidBeaconMgmt::stopCapture()
+{
+    Enter_Method("stopCapture");
+    capturing = false;
+}
+
+void RidBeaconMgmt::fastForward(simtime_t hyperperiod, simtime_t until, double rssiStddev)
+{
+    Enter_Method("fastForward");
+    cancelEvent(beaconTimer);
+
+    // repeat the captured hyperperiod until the end time, in time order per metric
+    for (int k = 1; ; k++) {
+        simtime_t shift = hyperperiod * k;
+        if (captured.empty() || captured.front().time + shift >= until) {
+            break;
+        }
+        for (const auto& entry : captured) {
+            simtime_t time = entry.time + shift;
+            if (time >= until) {
+                break;
+            }
+            double value = entry.value;
+            switch (entry.kind) {
+                case REPLAY_CONSTANT:
+                    break;
+                case REPLAY_TIME:
+                    value += shift.dbl();
+                    break;
+                case REPLAY_TIMESTAMP:
+                    value += shift.inUnit(SimTimeUnit::SIMTIME_MS);
+                    break;
+                case REPLAY_RSSI:
+                    if (rssiStddev > 0) {
+                        value = normal(value, rssiStddev);
+                    }
+                    break;
+                case REPLAY_NONE:
+                    continue;
+            }
+            recordValueAt(entry.signal, time, value);
+        }
+    }
+    captured.clear();
+}
+
 void RidBeaconMgmt::start()
 {
     Ieee80211MgmtApBase::start();
@@ -8,14 +8,35 @@
 #define __RID_BEACON_MGMT_H
 
 #include "inet/linklayer/ieee80211/mgmt/Ieee80211MgmtApBase.h"
+#include "inet/mobility/contract/IMobility.h"
 
 #include "RidBeaconFrame_m.h"
 
+#include "rid_recorder/RidLiveFeed.h"
+#include "rid_recorder/RidMemoryAccounting.h"
+
+#include <random>
+#include <unordered_map>
+
 using namespace inet;
 using namespace inet::ieee80211;
 
-class RidBeaconMgmt : public Ieee80211MgmtApBase, protected cListener
+class RidBeaconMgmt : public Ieee80211MgmtApBase, protected cListener, public IRidMemoryAccounting
 {
+  public:
+    /** values of one recorded reception, NaN where the packet had no such tag */
+    struct Reception {
+        simtime_t time;
+        double packetId;
+        double power;
+        double receptionTime;
+        double timestamp;
+        double serialNumber;
+        double txPosX, txPosY, txPosZ;
+        double txSpeedVertical, txSpeedHorizontal, txHeading;
+        double myPosX, myPosY, myPosZ;
+    };
+
   protected:
     std::string ssid;
     int serialNumber;
@@ -28,37 +49,114 @@ class RidBeaconMgmt : public Ieee80211MgmtApBase, protected cListener
     cMessage *beaconTimer = nullptr;
     cMessage *terminateMsg = nullptr;
     cModule *medium = nullptr;
+    std::shared_ptr<RidLiveFeed> liveFeed;
+
+    // event counters, recorded as scalars
+    uint64_t numBeaconsSent = 0;
+    uint64_t numBeaconsReceived = 0;
+    uint64_t numReceptionsRecorded = 0;
+    uint64_t numFramesDropped = 0;
+
+    /** which receptions end up in the recorded metrics */
+    enum RecordingPolicy {
+        RECORD_ALL,       // every reception
+        RECORD_STRIDE,    // every k-th reception per link
+        RECORD_RESERVOIR, // uniform sample of fixed size per link, recorded at the end
+        RECORD_DISTANCE,  // every k-th reception per link, k depending on the link distance
+    };
+
+    /** sampling state of the link from one transmitter to this host */
+    struct LinkRecording {
+        uint64_t seen = 0;
+        std::vector<Reception> reservoir;
+    };
+
+    RecordingPolicy recordingPolicy = RECORD_ALL;
+    int recordingStride = 1;
+    int reservoirSize = 0;
+    // private stream for reservoir sampling, so that turning it on leaves the simulation's own RNGs alone
+    std::mt19937_64 reservoirRng;
+    std::vector<double> distanceBands;
+    std::vector<int> distanceBandStrides;
+    std::unordered_map<int, LinkRecording> links;
+
+    /** Utility function: uniform integer in [0, bound] from reservoirRng */
+    uint64_t drawReservoirIndex(uint64_t bound);
+
+    /** how a recorded value changes when it is replayed one hyperperiod later */
+    enum ReplayKind {
+        REPLAY_CONSTANT,  // value repeats unchanged
+        REPLAY_TIME,      // value is a simulation time in seconds
+        REPLAY_TIMESTAMP, // value is a Remote ID timestamp in milliseconds
+        REPLAY_RSSI,      // value is re-sampled around the captured RSSI
+        REPLAY_NONE,      // value has no meaningful replay and is skipped
+    };
+
+    struct CapturedValue {
+        simsignal_t signal;
+        simtime_t time;
+        double value;
+        ReplayKind kind;
+    };
+
+    // values recorded while RidFastForward captures the steady state
+    bool capturing = false;
+    std::vector<CapturedValue> captured;
 
-    struct OutputVectors {
-        cOutVector power;
-        cOutVector time;
-        cOutVector timestamp;
-        cOutVector packetId;
-        cOutVector serialNumber;
-        cOutVector txPosX;
-        cOutVector txPosY;
-        cOutVector txPosZ;
-        cOutVector rxPosX;
-        cOutVector rxPosY;
-        cOutVector rxPosZ;
-        cOutVector txSpeedVertical;
-        cOutVector txSpeedHorizontal;
-        cOutVector txHeading;
-        cOutVector rxSpeedVertical;
-        cOutVector rxSpeedHorizontal;
-        cOutVector rxHeading;
-        cOutVector rxMyPosX;
-        cOutVector rxMyPosY;
-        cOutVector rxMyPosZ;
-    } recvec;
+  public:
+    /** emitted with the received Packet for every decoded beacon */
+    static simsignal_t beaconReceivedSignal;
+    /** emitted with the Packet of every beacon handed to the MAC */
+    static simsignal_t beaconSentSignal;
+
+    /** Remote ID metrics, recorded through the @statistic properties in the NED file */
+    //@{
+    static simsignal_t receptionPowerSignal;
+    static simsignal_t receptionTimeSignal;
+    static simsignal_t receptionTimestampSignal;
+    static simsignal_t receptionPacketIdSignal;
+    static simsignal_t receptionSerialNumberSignal;
+    static simsignal_t receptionPosXSignal;
+    static simsignal_t receptionPosYSignal;
+    static simsignal_t receptionPosZSignal;
+    static simsignal_t receptionSpeedVerticalSignal;
+    static simsignal_t receptionSpeedHorizontalSignal;
+    static simsignal_t receptionHeadingSignal;
+    static simsignal_t receptionMyPosXSignal;
+    static simsignal_t receptionMyPosYSignal;
+    static simsignal_t receptionMyPosZSignal;
+    static simsignal_t transmissionPosXSignal;
+    static simsignal_t transmissionPosYSignal;
+    static simsignal_t transmissionPosZSignal;
+    static simsignal_t transmissionSpeedVerticalSignal;
+    static simsignal_t transmissionSpeedHorizontalSignal;
+    static simsignal_t transmissionHeadingSignal;
+    //@}
 
   public:
     RidBeaconMgmt() {}
     virtual ~RidBeaconMgmt();
 
+    bool isTransmitting() const { return transmitBeacon; }
+    simtime_t getBeaconInterval() const { return beaconInterval; }
+    simtime_t getStartupJitter() const { return startupJitter; }
+
+    virtual void accountMemory(RidMemoryUsage& usage) const override;
+
+    /** Utility function: fills in the Remote ID fields of a genuine beacon sent at the given time */
+    static void fillRidFields(const inet::Ptr<RidBeaconFrame>& body, int serialNumber, simtime_t time, IMobility *mobility);
+
+    /** fast-forward support, see RidFastForward */
+    //@{
+    virtual void startCapture();
+    virtual void stopCapture();
+    virtual void fastForward(simtime_t hyperperiod, simtime_t until, double rssiStddev);
+    //@}
+
   protected:
     virtual int numInitStages() const override { return NUM_INIT_STAGES; }
     virtual void initialize(int) override;
+    virtual void finish() override;
 
     /** Implements abstract Ieee80211MgmtBase method */
     virtual void handleTimer(cMessage *msg) override;
@@ -79,6 +177,34 @@ class RidBeaconMgmt : public Ieee80211MgmtApBase, protected cListener
     /** Utility function: handles a received beacon frame */
     virtual void handleBeaconFrame(Packet *packet, const Ptr<const Ieee80211MgmtHeader>& header) override;
 
+    /** Utility function: emits a metric and remembers it while capturing */
+    void recordValue(simsignal_t signal, double value, ReplayKind kind);
+
+    /** Utility function: emits a metric with an explicit timestamp, for deferred and replayed values */
+    void recordValueAt(simsignal_t signal, simtime_t time, double value);
+
+    /**
+     * Recording hooks, see RidBeaconMgmtRec for the variants chosen at compile time. The
+     * defaults emit the metric signals. Receptions are only sampled and gathered at all
+     * while isRecordingReceptions() is true.
+     */
+    //@{
+    virtual bool isRecordingReceptions() const;
+    virtual void recordTransmission(const Ptr<const RidBeaconFrame>& body);
+    /** records the values of a reception, at its original time if deferred */
+    virtual void recordReception(const Reception& reception, bool deferred);
+    //@}
+
+    /**
+     * Utility function: applies the recording policy to a reception on the link from the given
+     * transmitter. Returns false if the reception is not recorded, otherwise sets slot to the
+     * reservoir entry to overwrite, or to nullptr if the reception is recorded right away.
+     */
+    virtual bool sampleReception(int serialNumber, double distance, Reception *& slot);
+
+    /** Utility function: drops a management frame this module has no use for */
+    virtual void dropUnhandledFrame(Packet *packet);
+
     /** Utility function: hook for derived classes to process received Remote ID message */
     virtual void hookRidMsg(Packet *packet, const Ptr<const RidBeaconFrame>& beaconBody, double rssiDbm) {};
 
@@ -90,16 +216,16 @@ class RidBeaconMgmt : public Ieee80211MgmtApBase, protected cListener
 
     /** Unused overrides of base class */
     //@{
-    virtual void handleAssociationRequestFrame(Packet *packet, const Ptr<const Ieee80211MgmtHeader>& header) override {};
-    virtual void handleAssociationResponseFrame(Packet *packet, const Ptr<const Ieee80211MgmtHeader>& header) override {};
-    virtual void handleAuthenticationFrame(Packet *packet, const Ptr<const Ieee80211MgmtHeader>& header) override {};
+    virtual void handleAssociationRequestFrame(Packet *packet, const Ptr<const Ieee80211MgmtHeader>& header) override { dropUnhandledFrame(packet); };
+    virtual void handleAssociationResponseFrame(Packet *packet, const Ptr<const Ieee80211MgmtHeader>& header) override { dropUnhandledFrame(packet); };
+    virtual void handleAuthenticationFrame(Packet *packet, const Ptr<const Ieee80211MgmtHeader>& header) override { dropUnhandledFrame(packet); };
     virtual void handleCommand(int msgkind, cObject *ctrl) override {};
-    virtual void handleDeauthenticationFrame(Packet *packet, const Ptr<const Ieee80211MgmtHeader>& header) override {};
-    virtual void handleDisassociationFrame(Packet *packet, const Ptr<const Ieee80211MgmtHeader>& header) override {};
-    virtual void handleReassociationRequestFrame(Packet *packet, const Ptr<const Ieee80211MgmtHeader>& header) override {};
-    virtual void handleReassociationResponseFrame(Packet *packet, const Ptr<const Ieee80211MgmtHeader>& header) override {};
-    virtual void handleProbeRequestFrame(Packet *packet, const Ptr<const Ieee80211MgmtHeader>& header) override {};
-    virtual void handleProbeResponseFrame(Packet *packet, const Ptr<const Ieee80211MgmtHeader>& header) override {};
+    virtual void handleDeauthenticationFrame(Packet *packet, const Ptr<const Ieee80211MgmtHeader>& header) override { dropUnhandledFrame(packet); };
+    virtual void handleDisassociationFrame(Packet *packet, const Ptr<const Ieee80211MgmtHeader>& header) override { dropUnhandledFrame(packet); };
+    virtual void handleReassociationRequestFrame(Packet *packet, const Ptr<const Ieee80211MgmtHeader>& header) override { dropUnhandledFrame(packet); };
+    virtual void handleReassociationResponseFrame(Packet *packet, const Ptr<const Ieee80211MgmtHeader>& header) override { dropUnhandledFrame(packet); };
+    virtual void handleProbeRequestFrame(Packet *packet, const Ptr<const Ieee80211MgmtHeader>& header) override { dropUnhandledFrame(packet); };
+    virtual void handleProbeResponseFrame(Packet *packet, const Ptr<const Ieee80211MgmtHeader>& header) override { dropUnhandledFrame(packet); };
     //@}
 };
 
@@ -0,0 +1,102 @@
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+//
+
+#include "RidBeaconMgmtRec.h"
+
+#include "inet/common/ModuleAccess.h"
+
+#include <filesystem>
+
+Define_Module(RidBeaconMgmtNoRec);
+Define_Module(RidBeaconMgmtVector);
+Define_Module(RidBeaconMgmtColumnar);
+
+template <>
+bool RidBeaconMgmtRec<RidNoRecording>::isRecordingReceptions() const
+{
+    return false;
+}
+
+template <>
+void RidBeaconMgmtRec<RidNoRecording>::recordTransmission(const Ptr<const RidBeaconFrame>& body)
+{
+}
+
+template <>
+void RidBeaconMgmtRec<RidNoRecording>::recordReception(const Reception& reception, bool deferred)
+{
+}
+
+template <>
+void RidBeaconMgmtRec<RidColumnarRecording>::initialize(int stage)
+{
+    RidBeaconMgmt::initialize(stage);
+
+    if (stage == INITSTAGE_LOCAL) {
+        std::string columnsDir = par("columnsDir").stdstringValue();
+        if (columnsDir.empty()) {
+            // repetitions and parallel runs must not overwrite each other's files
+            auto config = dynamic_cast<cConfigurationEx *>(getEnvir()->getConfig());
+            if (config == nullptr)
+                throw cRuntimeError("columnsDir must be set when the run has no ini configuration");
+            columnsDir = std::string(config->getVariable(CFGVAR_RESULTDIR)) + "/" + config->getVariable(CFGVAR_CONFIGNAME)
+                + "-" + config->getVariable(CFGVAR_ITERATIONVARSF) + "#" + config->getVariable(CFGVAR_REPETITION) + "-columns";
+        }
+        std::filesystem::create_directories(columnsDir);
+        std::string prefix = columnsDir + "/host" + std::to_string(getContainingNode(this)->getIndex());
+        // one small buffer per file, there are two files for every host
+        size_t bufferBytes = 64 << 10;
+        try {
+            recording.transmissions = std::make_unique<utils::NpyWriter<double>>(prefix + "-transmissions.npy", std::vector<size_t>{8}, bufferBytes);
+            recording.receptions = std::make_unique<utils::NpyWriter<double>>(prefix + "-receptions.npy", std::vector<size_t>{15}, bufferBytes);
+        }
+        catch (std::exception& e) {
+            throw cRuntimeError("%s", e.what());
+        }
+    }
+}
+
+template <>
+void RidBeaconMgmtRec<RidColumnarRecording>::finish()
+{
+    // writes the reservoir samples first
+    RidBeaconMgmt::finish();
+    try {
+        recording.transmissions->close();
+        recording.receptions->close();
+    }
+    catch (std::exception& e) {
+        throw cRuntimeError("%s", e.what());
+    }
+}
+
+template <>
+bool RidBeaconMgmtRec<RidColumnarRecording>::isRecordingReceptions() const
+{
+    return true;
+}
+
+template <>
+void RidBeaconMgmtRec<RidColumnarRecording>::recordTransmission(const Ptr<const RidBeaconFrame>& body)
+{
+    double row[] = {
+        simTime().dbl(), (double)body->getSerialNumber(),
+        body->getPosX(), body->getPosY(), body->getPosZ(),
+        body->getSpeedVertical(), body->getSpeedHorizontal(), body->getHeading(),
+    };
+    recording.transmissions->append(row);
+}
+
+template <>
+void RidBeaconMgmtRec<RidColumnarRecording>::recordReception(const Reception& reception, bool deferred)
+{
+    double row[] = {
+        reception.time.dbl(), reception.packetId, reception.power, reception.receptionTime,
+        reception.timestamp, reception.serialNumber,
+        reception.txPosX, reception.txPosY, reception.txPosZ,
+        reception.txSpeedVertical, reception.txSpeedHorizontal, reception.txHeading,
+        reception.myPosX, reception.myPosY, reception.myPosZ,
+    };
+    recording.receptions->append(row);
+}
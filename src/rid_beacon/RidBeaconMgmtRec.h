@@ -0,0 +1,62 @@
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+//
+
+#ifndef __RID_BEACON_MGMT_REC_H
+#define __RID_BEACON_MGMT_REC_H
+
+#include "RidBeaconMgmt.h"
+
+#include "utils/npy_writer.h"
+
+#include <memory>
+
+/** records nothing, every recording hook compiles to an empty function */
+struct RidNoRecording {};
+
+/** records the metric signals, like RidBeaconMgmt itself */
+struct RidVectorRecording {};
+
+/** appends fixed numeric columns to per-host .npy files, no signals involved */
+struct RidColumnarRecording
+{
+    std::unique_ptr<utils::NpyWriter<double>> transmissions;
+    std::unique_ptr<utils::NpyWriter<double>> receptions;
+};
+
+//
+// RidBeaconMgmt with the recording side chosen at compile time. Each
+// recording type has its own specialization of the hooks and is registered
+// as a module type of its own (see RidBeaconMgmtRec.ned), so throughput runs
+// with RidBeaconMgmtNoRec do none of the recording work at all.
+//
+template <typename Recording>
+class RidBeaconMgmtRec : public RidBeaconMgmt
+{
+  protected:
+    Recording recording;
+
+  protected:
+    virtual void initialize(int stage) override { RidBeaconMgmt::initialize(stage); }
+    virtual void finish() override { RidBeaconMgmt::finish(); }
+
+    virtual bool isRecordingReceptions() const override { return RidBeaconMgmt::isRecordingReceptions(); }
+    virtual void recordTransmission(const Ptr<const RidBeaconFrame>& body) override { RidBeaconMgmt::recordTransmission(body); }
+    virtual void recordReception(const Reception& reception, bool deferred) override { RidBeaconMgmt::recordReception(reception, deferred); }
+};
+
+template <> bool RidBeaconMgmtRec<RidNoRecording>::isRecordingReceptions() const;
+template <> void RidBeaconMgmtRec<RidNoRecording>::recordTransmission(const Ptr<const RidBeaconFrame>& body);
+template <> void RidBeaconMgmtRec<RidNoRecording>::recordReception(const Reception& reception, bool deferred);
+
+template <> void RidBeaconMgmtRec<RidColumnarRecording>::initialize(int stage);
+template <> void RidBeaconMgmtRec<RidColumnarRecording>::finish();
+template <> bool RidBeaconMgmtRec<RidColumnarRecording>::isRecordingReceptions() const;
+template <> void RidBeaconMgmtRec<RidColumnarRecording>::recordTransmission(const Ptr<const RidBeaconFrame>& body);
+template <> void RidBeaconMgmtRec<RidColumnarRecording>::recordReception(const Reception& reception, bool deferred);
+
+class RidBeaconMgmtNoRec : public RidBeaconMgmtRec<RidNoRecording> {};
+class RidBeaconMgmtVector : public RidBeaconMgmtRec<RidVectorRecording> {};
+class RidBeaconMgmtColumnar : public RidBeaconMgmtRec<RidColumnarRecording> {};
+
+#endif
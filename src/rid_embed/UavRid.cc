@@ -0,0 +1,287 @@
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+//
+// Based on samples/embedding/embedding.cc from OMNeT++
+//
+
+#include "UavRid.h"
+
+#include <omnetpp.h>
+#include <omnetpp/cnullenvir.h>
+
+#include "inet/common/ModuleAccess.h"
+#include "inet/mobility/contract/IMobility.h"
+#include "inet/physicallayer/wireless/common/contract/packetlevel/SignalTag_m.h"
+
+#include "detectors/rssi_mlat/RssiMlatGcs.h"
+#include "rid_beacon/RidBeaconFrame_m.h"
+#include "rid_beacon/RidBeaconMgmt.h"
+
+#include <cmath>
+#include <memory>
+#include <stdexcept>
+
+using namespace omnetpp;
+using namespace inet;
+using namespace inet::physicallayer;
+
+namespace uavrid
+{
+    //
+    // Parameter and typename assignments of one scenario, the in-memory
+    // counterpart of the ini lines rid-one-off.sh passes on the command line.
+    // Keys are full paths, or "**." followed by the path suffix.
+    //
+    class Assignments
+    {
+      protected:
+        std::vector<std::pair<std::string, std::string>> entries;
+
+        static bool matches(const std::string& key, const std::string& path) {
+            if (key.compare(0, 3, "**.") == 0) {
+                size_t n = key.size() - 2; // suffix including the dot
+                return path.size() > n && path.compare(path.size() - n, n, key, 2, n) == 0;
+            }
+            return key == path;
+        }
+
+      public:
+        void set(const std::string& key, const std::string& value) { entries.emplace_back(key, value); }
+        void set(const std::string& key, double value, const char *unit) { set(key, cValue(value, unit).str()); }
+        void set(const std::string& key, intval_t value) { set(key, std::to_string(value)); }
+        void set(const std::string& key, bool value) { set(key, std::string(value ? "true" : "false")); }
+
+        /** Last assignment wins, like command line options override the ini */
+        const char *find(const std::string& path) const {
+            for (auto it = entries.rbegin(); it != entries.rend(); ++it)
+                if (matches(it->first, path))
+                    return it->second.c_str();
+            return nullptr;
+        }
+    };
+
+    class EmbedConfig : public cConfiguration
+    {
+      protected:
+        class NullKeyValue : public KeyValue {
+          public:
+            virtual const char *getKey() const override {return nullptr;}
+            virtual const char *getValue() const override {return nullptr;}
+            virtual const char *getBaseDirectory() const override {return nullptr;}
+        };
+        NullKeyValue nullKeyValue;
+        const Assignments *assignments;
+
+      protected:
+        virtual const char *substituteVariables(const char *value) const override {return value;}
+
+      public:
+        explicit EmbedConfig(const Assignments *assignments) : assignments(assignments) {}
+
+        virtual const char *getConfigValue(const char *key) const override {return nullptr;}
+        virtual const KeyValue& getConfigEntry(const char *key) const override {return nullKeyValue;}
+        virtual const KeyValue& getPerObjectConfigEntry(const char *objectFullPath, const char *keySuffix) const override {return nullKeyValue;}
+
+        /** Only typename assignments are per-object entries here */
+        virtual const char *getPerObjectConfigValue(const char *objectFullPath, const char *keySuffix) const override {
+            if (strcmp(keySuffix, "typename") != 0)
+                return nullptr;
+            return assignments->find(std::string(objectFullPath) + ".typename");
+        }
+    };
+
+    //
+    // Environment of one run, owned and deleted by its cSimulation
+    //
+    class EmbedEnvir : public cNullEnvir
+    {
+      protected:
+        const Assignments *assignments;
+        cMersenneTwister rng;
+
+      public:
+        EmbedEnvir(const Assignments *assignments, int seed) : cNullEnvir(0, nullptr, new EmbedConfig(assignments)), assignments(assignments) {
+            rng.initialize(seed, 0, 1, 0, 1, getConfig());
+        }
+
+        virtual int getNumRNGs() const override { return 1; }
+        virtual cRNG *getRNG(int k) override { return &rng; }
+
+        virtual void readParameter(cPar *par) override {
+            const char *value = assignments->find(par->getFullPath());
+            if (value != nullptr)
+                par->parse(value);
+            else if (par->containsValue())
+                par->acceptDefault();
+            else
+                throw cRuntimeError("No value for parameter %s", par->getFullPath().c_str());
+        }
+    };
+
+    //
+    // Collects every decoded beacon of the network being run
+    //
+    class ReceptionCollector : public cListener
+    {
+      public:
+        std::vector<Reception> receptions;
+
+        virtual void receiveSignal(cComponent *source, simsignal_t signalID, cObject *obj, cObject *details) override {
+            auto packet = check_and_cast<Packet *>(obj);
+            auto beaconBody = packet->peekAtFront<RidBeaconFrame>();
+            auto host = getContainingNode(check_and_cast<cModule *>(source));
+            auto mobility = check_and_cast<IMobility *>(host->getSubmodule("mobility"));
+            Coord position = mobility->getCurrentPosition();
+
+            Reception reception;
+            reception.receiverSerialNumber = source->par("serialNumber");
+            reception.senderSerialNumber = beaconBody->getSerialNumber();
+            reception.time = simTime().dbl();
+            auto signalPowerInd = packet->findTag<SignalPowerInd>();
+            reception.rssi = signalPowerInd ? 10 * std::log10(signalPowerInd->getPower().get() * 1000) : NAN;
+            reception.timestamp = beaconBody->getTimestamp();
+            reception.txPosX = beaconBody->getPosX();
+            reception.txPosY = beaconBody->getPosY();
+            reception.txPosZ = beaconBody->getPosZ();
+            reception.rxPosX = position.x;
+            reception.rxPosY = position.y;
+            reception.rxPosZ = position.z;
+            receptions.push_back(reception);
+        }
+    };
+
+    //
+    // Collects every fix of the GCS, which hands them out instead of keeping them
+    //
+    class FixCollector : public cListener
+    {
+      public:
+        std::vector<Fix> fixes;
+
+        virtual void receiveSignal(cComponent *source, simsignal_t signalID, cObject *obj, cObject *details) override {
+            auto f = check_and_cast<RssiMlatGcs::Fix *>(obj);
+            fixes.push_back({f->senderSerialNumber, f->timestamp, f->time.dbl(), f->x, f->y, f->z, f->txPosX, f->txPosY, f->txPosZ, f->numReports});
+        }
+    };
+
+    static std::unique_ptr<cStaticFlag> staticFlag;
+
+    void initialize(const std::vector<std::string>& nedFolders)
+    {
+        if (staticFlag)
+            throw std::runtime_error("uavrid::initialize() called twice");
+        staticFlag = std::make_unique<cStaticFlag>();
+        CodeFragments::executeAll(CodeFragments::STARTUP);
+        SimTime::setScaleExp(-12);
+        try {
+            for (auto& folder : nedFolders)
+                cSimulation::loadNedSourceFolder(folder.c_str());
+            cSimulation::doneLoadingNedFiles();
+        }
+        catch (std::exception& e) {
+            throw std::runtime_error(std::string("Cannot load NED files: ") + e.what());
+        }
+    }
+
+    static Assignments makeAssignments(const Scenario& scenario, const std::string& network)
+    {
+        Assignments a;
+        a.set(network + ".numHosts", (intval_t)scenario.hosts.size());
+        a.set(network + ".hasVisualizer", false);
+        a.set(network + ".radioMedium.backgroundNoise.power", scenario.backgroundNoise, "dBm");
+        // no configurator needed (there is no communication between hosts)
+        a.set("**.networkConfiguratorModule", std::string("\"\""));
+
+        for (size_t i = 0; i < scenario.hosts.size(); i++) {
+            const Host& host = scenario.hosts[i];
+            std::string path = network + ".host[" + std::to_string(i) + "]";
+            const char *type = host.role == SPOOFER ? "uav_rid.spoofers.static_location.StaticLocationSpooferHost"
+                             : scenario.localization ? "uav_rid.detectors.rssi_mlat.RssiMlatHost"
+                             : "uav_rid.rid_host.DroneHost";
+            a.set(path + ".typename", std::string("\"") + type + "\"");
+
+            a.set(path + ".mobility.typename", std::string("\"LinearMobility\""));
+            a.set(path + ".mobility.initFromDisplayString", false);
+            a.set(path + ".mobility.initialX", host.x, "m");
+            a.set(path + ".mobility.initialY", host.y, "m");
+            a.set(path + ".mobility.initialZ", host.z, "m");
+            a.set(path + ".mobility.speed", host.speed, "mps");
+            a.set(path + ".mobility.initialMovementHeading", host.heading, "deg");
+            a.set(path + ".mobility.initialMovementElevation", host.elevation, "deg");
+
+            std::string mgmt = path + ".wlan[0].mgmt";
+            a.set(mgmt + ".serialNumber", (intval_t)host.serialNumber);
+            a.set(mgmt + ".beaconInterval", scenario.beaconInterval, "s");
+            if (scenario.startupJitter >= 0)
+                a.set(mgmt + ".startupJitter", scenario.startupJitter, "s");
+            a.set(mgmt + ".transmitBeacon", host.role != RECEIVER);
+            a.set(mgmt + ".oneOff", scenario.oneOff && host.role != RECEIVER);
+            if (host.role == SPOOFER) {
+                a.set(mgmt + ".spoofPosX", host.spoofX, nullptr);
+                a.set(mgmt + ".spoofPosY", host.spoofY, nullptr);
+                a.set(mgmt + ".spoofPosZ", host.spoofZ, nullptr);
+            }
+        }
+        return a;
+    }
+
+    Results run(const Scenario& scenario)
+    {
+        if (!staticFlag)
+            throw std::runtime_error("uavrid::initialize() must be called first");
+
+        const char *networkName = scenario.localization ? "uav_rid.simulations.localization.RssiMlat" : "uav_rid.rid_network.BasicUav";
+        cModuleType *networkType = cModuleType::find(networkName);
+        if (networkType == nullptr)
+            throw std::runtime_error(std::string("Network ") + networkName + " not found, check the NED folders");
+
+        Assignments assignments = makeAssignments(scenario, networkType->getName());
+        cSimulation *sim = new cSimulation("simulation", new EmbedEnvir(&assignments, scenario.seed));
+        cSimulation::setActiveSimulation(sim);
+        ReceptionCollector collector;
+        FixCollector fixCollector;
+        Results results;
+        std::string error;
+        try {
+            sim->setupNetwork(networkType);
+            sim->setSimulationTimeLimit(scenario.timeLimit);
+            sim->getSystemModule()->subscribe(RidBeaconMgmt::beaconReceivedSignal, &collector);
+            sim->getSystemModule()->subscribe(RssiMlatGcs::fixComputedSignal, &fixCollector);
+            sim->callInitialize();
+            try {
+                while (true) {
+                    cEvent *event = sim->takeNextEvent();
+                    if (event == nullptr)
+                        break;
+                    sim->executeEvent(event);
+                }
+            }
+            catch (cTerminationException&) {
+                // sim time limit or endSimulation(), both are regular ends
+            }
+            results.endTime = sim->getSimTime().dbl();
+            sim->callFinish();
+            sim->getSystemModule()->unsubscribe(RidBeaconMgmt::beaconReceivedSignal, &collector);
+            sim->getSystemModule()->unsubscribe(RssiMlatGcs::fixComputedSignal, &fixCollector);
+        }
+        catch (std::exception& e) {
+            error = e.what();
+        }
+        if (sim->getSystemModule() != nullptr)
+            sim->deleteNetwork();
+        cSimulation::setActiveSimulation(nullptr);
+        delete sim;
+
+        if (!error.empty())
+            throw std::runtime_error(error);
+        results.receptions = std::move(collector.receptions);
+        results.fixes = std::move(fixCollector.fixes);
+        return results;
+    }
+
+    void shutdown()
+    {
+        CodeFragments::executeAll(CodeFragments::SHUTDOWN);
+        staticFlag.reset();
+    }
+}
@@ -0,0 +1,84 @@
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+//
+
+#ifndef __UAV_RID_H
+#define __UAV_RID_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+//
+// In-process API of libuavrid. Scenarios are described with plain structs,
+// run on the BasicUav (or RssiMlat) network without Cmdenv, ini files or
+// result files, and their results come back as arrays.
+//
+// NED files are loaded once by initialize(). Runs are sequential: OMNeT++
+// has one active simulation per process, so calls must not overlap.
+//
+namespace uavrid
+{
+    enum Role {
+        RECEIVER,    // listens only
+        TRANSMITTER, // broadcasts its true position
+        SPOOFER,     // broadcasts the spoofed position of its Host
+    };
+
+    struct Host {
+        int serialNumber = 0;
+        Role role = RECEIVER;
+        double x = 0, y = 0, z = 0;     // initial position in meters
+        double speed = 0;               // linear mobility in meters per second
+        double heading = 0;             // degrees from North
+        double elevation = 0;           // degrees from horizontal
+        double spoofX = 0, spoofY = 0, spoofZ = 0; // claimed position of a SPOOFER
+    };
+
+    struct Scenario {
+        std::vector<Host> hosts;
+        double beaconInterval = 0.1;    // seconds
+        double startupJitter = -1;      // seconds, negative is one beacon interval
+        double timeLimit = 1;           // seconds of simulation time
+        bool oneOff = false;            // end after the first transmission is over, like rid-one-off.sh
+        bool localization = false;      // run the RSSI multilateration GCS
+        double backgroundNoise = -100;  // dBm
+        int seed = 0;                   // seed set of the random number generator
+    };
+
+    struct Reception {
+        int receiverSerialNumber;
+        int senderSerialNumber;         // as claimed in the beacon
+        double time;                    // seconds
+        double rssi;                    // dBm
+        int64_t timestamp;              // Remote ID timestamp
+        double txPosX, txPosY, txPosZ;  // position claimed in the beacon
+        double rxPosX, rxPosY, rxPosZ;  // receiver position
+    };
+
+    struct Fix {
+        int senderSerialNumber;
+        int64_t timestamp;
+        double time;
+        double x, y, z;                 // estimated position
+        double txPosX, txPosY, txPosZ;  // position claimed in the beacon
+        int numReports;
+    };
+
+    struct Results {
+        std::vector<Reception> receptions;
+        std::vector<Fix> fixes;         // only with Scenario::localization
+        double endTime = 0;             // simulation time the run stopped at
+    };
+
+    /** Loads the NED folders, typically the src and simulations folders of uav_rid and the src folder of INET */
+    void initialize(const std::vector<std::string>& nedFolders);
+
+    /** Builds, runs and deletes one scenario, throws std::runtime_error on errors */
+    Results run(const Scenario& scenario);
+
+    /** Releases what initialize() set up */
+    void shutdown();
+}
+
+#endif
@@ -0,0 +1,91 @@
+/*
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ *
+ * C interface of libuavrid, see UavRid.h for the C++ one. Functions return
+ * 0 on success and -1 on error, with uavrid_last_error() describing it.
+ */
+
+#ifndef __UAV_RID_C_H
+#define __UAV_RID_C_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    UAVRID_RECEIVER = 0,
+    UAVRID_TRANSMITTER = 1,
+    UAVRID_SPOOFER = 2,
+} uavrid_role;
+
+typedef struct {
+    int serial_number;
+    uavrid_role role;
+    double x, y, z;
+    double speed;
+    double heading;
+    double elevation;
+    double spoof_x, spoof_y, spoof_z;
+} uavrid_host;
+
+typedef struct {
+    const uavrid_host *hosts;
+    size_t num_hosts;
+    double beacon_interval;
+    double startup_jitter;      /* negative is one beacon interval */
+    double time_limit;
+    int one_off;
+    int localization;
+    double background_noise;    /* dBm */
+    int seed;
+} uavrid_scenario;
+
+typedef struct {
+    int receiver_serial_number;
+    int sender_serial_number;
+    double time;
+    double rssi;
+    int64_t timestamp;
+    double tx_pos_x, tx_pos_y, tx_pos_z;
+    double rx_pos_x, rx_pos_y, rx_pos_z;
+} uavrid_reception;
+
+typedef struct {
+    int sender_serial_number;
+    int64_t timestamp;
+    double time;
+    double x, y, z;
+    double tx_pos_x, tx_pos_y, tx_pos_z;
+    int num_reports;
+} uavrid_fix;
+
+typedef struct {
+    uavrid_reception *receptions;
+    size_t num_receptions;
+    uavrid_fix *fixes;
+    size_t num_fixes;
+    double end_time;
+} uavrid_results;
+
+/* Fills a scenario with the defaults of uavrid::Scenario */
+void uavrid_scenario_init(uavrid_scenario *scenario);
+
+int uavrid_initialize(const char *const *ned_folders, size_t num_ned_folders);
+
+/* On success *results must be released with uavrid_results_free() */
+int uavrid_run(const uavrid_scenario *scenario, uavrid_results **results);
+
+void uavrid_results_free(uavrid_results *results);
+
+void uavrid_shutdown(void);
+
+const char *uavrid_last_error(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,135 @@
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+//
+
+#include "uav_rid.h"
+#include "UavRid.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <string>
+
+static std::string lastError;
+
+template <typename T>
+static T *copyArray(const std::vector<T>& items)
+{
+    if (items.empty())
+        return nullptr;
+    T *array = static_cast<T *>(std::malloc(items.size() * sizeof(T)));
+    if (array == nullptr)
+        throw std::bad_alloc();
+    std::memcpy(array, items.data(), items.size() * sizeof(T));
+    return array;
+}
+
+extern "C" {
+
+void uavrid_scenario_init(uavrid_scenario *scenario)
+{
+    uavrid::Scenario defaults;
+    std::memset(scenario, 0, sizeof(*scenario));
+    scenario->beacon_interval = defaults.beaconInterval;
+    scenario->startup_jitter = defaults.startupJitter;
+    scenario->time_limit = defaults.timeLimit;
+    scenario->one_off = defaults.oneOff;
+    scenario->localization = defaults.localization;
+    scenario->background_noise = defaults.backgroundNoise;
+    scenario->seed = defaults.seed;
+}
+
+int uavrid_initialize(const char *const *ned_folders, size_t num_ned_folders)
+{
+    try {
+        uavrid::initialize(std::vector<std::string>(ned_folders, ned_folders + num_ned_folders));
+        return 0;
+    }
+    catch (std::exception& e) {
+        lastError = e.what();
+        return -1;
+    }
+}
+
+int uavrid_run(const uavrid_scenario *scenario, uavrid_results **results)
+{
+    try {
+        uavrid::Scenario s;
+        for (size_t i = 0; i < scenario->num_hosts; i++) {
+            const uavrid_host& h = scenario->hosts[i];
+            uavrid::Host host;
+            host.serialNumber = h.serial_number;
+            host.role = static_cast<uavrid::Role>(h.role);
+            host.x = h.x;
+            host.y = h.y;
+            host.z = h.z;
+            host.speed = h.speed;
+            host.heading = h.heading;
+            host.elevation = h.elevation;
+            host.spoofX = h.spoof_x;
+            host.spoofY = h.spoof_y;
+            host.spoofZ = h.spoof_z;
+            s.hosts.push_back(host);
+        }
+        s.beaconInterval = scenario->beacon_interval;
+        s.startupJitter = scenario->startup_jitter;
+        s.timeLimit = scenario->time_limit;
+        s.oneOff = scenario->one_off != 0;
+        s.localization = scenario->localization != 0;
+        s.backgroundNoise = scenario->background_noise;
+        s.seed = scenario->seed;
+
+        uavrid::Results r = uavrid::run(s);
+
+        std::vector<uavrid_reception> receptions;
+        for (auto& x : r.receptions)
+            receptions.push_back({x.receiverSerialNumber, x.senderSerialNumber, x.time, x.rssi, x.timestamp,
+                                  x.txPosX, x.txPosY, x.txPosZ, x.rxPosX, x.rxPosY, x.rxPosZ});
+        std::vector<uavrid_fix> fixes;
+        for (auto& x : r.fixes)
+            fixes.push_back({x.senderSerialNumber, x.timestamp, x.time, x.x, x.y, x.z,
+                             x.txPosX, x.txPosY, x.txPosZ, x.numReports});
+
+        auto out = static_cast<uavrid_results *>(std::calloc(1, sizeof(uavrid_results)));
+        if (out == nullptr)
+            throw std::bad_alloc();
+        try {
+            out->receptions = copyArray(receptions);
+            out->num_receptions = receptions.size();
+            out->fixes = copyArray(fixes);
+            out->num_fixes = fixes.size();
+            out->end_time = r.endTime;
+        }
+        catch (...) {
+            uavrid_results_free(out);
+            throw;
+        }
+        *results = out;
+        return 0;
+    }
+    catch (std::exception& e) {
+        lastError = e.what();
+        return -1;
+    }
+}
+
+void uavrid_results_free(uavrid_results *results)
+{
+    if (results == nullptr)
+        return;
+    std::free(results->receptions);
+    std::free(results->fixes);
+    std::free(results);
+}
+
+void uavrid_shutdown(void)
+{
+    uavrid::shutdown();
+}
+
+const char *uavrid_last_error(void)
+{
+    return lastError.c_str();
+}
+
+}
@@ -0,0 +1,129 @@
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+//
+
+#include "RidFastForward.h"
+
+#include "inet/common/ModuleAccess.h"
+#include "inet/mobility/contract/IMobility.h"
+
+#include <numeric>
+
+Define_Module(RidFastForward);
+
+RidFastForward::~RidFastForward()
+{
+    cancelAndDelete(captureStartMsg);
+    cancelAndDelete(captureEndMsg);
+}
+
+void RidFastForward::initialize(int stage)
+{
+    if (stage == INITSTAGE_LOCAL) {
+        enabled = par("enabled");
+        warmup = par("warmup");
+        until = par("until");
+        rssiStddev = par("rssiStddev");
+        captureStartMsg = new cMessage("captureStart");
+        captureEndMsg = new cMessage("captureEnd");
+    }
+    else if (stage == INITSTAGE_LAST && enabled) {
+        cSimulation *simulation = getSimulation();
+        for (int id = 0; id <= simulation->getLastComponentId(); id++) {
+            auto mgmt = dynamic_cast<RidBeaconMgmt *>(simulation->getModule(id));
+            if (mgmt != nullptr) {
+                mgmts.push_back(mgmt);
+            }
+        }
+
+        hyperperiod = computeHyperperiod();
+        if (hyperperiod == SIMTIME_ZERO) {
+            EV_WARN << "Fast-forward disabled: no host transmits beacons" << endl;
+            return;
+        }
+        if (!isStatic()) {
+            EV_WARN << "Fast-forward disabled: the scene is not static" << endl;
+            return;
+        }
+
+        // by default wait for every first beacon plus one full hyperperiod to settle
+        simtime_t start = warmup;
+        if (start < SIMTIME_ZERO) {
+            start = SIMTIME_ZERO;
+            for (auto mgmt : mgmts) {
+                start = std::max(start, mgmt->getStartupJitter());
+            }
+            start += hyperperiod;
+        }
+        EV_INFO << "Fast-forward captures hyperperiod " << hyperperiod << " from t=" << start << endl;
+        scheduleAt(start, captureStartMsg);
+    }
+}
+
+void RidFastForward::handleMessage(cMessage *msg)
+{
+    if (msg == captureStartMsg) {
+        for (auto mgmt : mgmts) {
+            mgmt->startCapture();
+        }
+        scheduleAfter(hyperperiod, captureEndMsg);
+    }
+    else if (msg == captureEndMsg) {
+        for (auto mgmt : mgmts) {
+            mgmt->stopCapture();
+        }
+        // something might have started moving since initialization
+        if (!isStatic()) {
+            EV_WARN << "Fast-forward aborted: the scene is no longer static" << endl;
+            return;
+        }
+        simtime_t end = computeEndTime();
+        EV_INFO << "Fast-forwarding from t=" << simTime() << " to t=" << end << endl;
+        for (auto mgmt : mgmts) {
+            mgmt->fastForward(hyperperiod, end, rssiStddev);
+        }
+        recordScalar("fast-forward start", simTime() - hyperperiod);
+        recordScalar("fast-forward hyperperiod", hyperperiod);
+        recordScalar("fast-forward end", end);
+        endSimulation();
+    }
+    else {
+        throw cRuntimeError("internal error: unrecognized message '%s'", msg->getName());
+    }
+}
+
+bool RidFastForward::isStatic() const
+{
+    for (auto mgmt : mgmts) {
+        auto host = getContainingNode(mgmt);
+        auto mobility = check_and_cast<IMobility *>(host->getSubmodule("mobility"));
+        if (mobility->getCurrentVelocity() != Coord::ZERO) {
+            return false;
+        }
+    }
+    return true;
+}
+
+simtime_t RidFastForward::computeHyperperiod() const
+{
+    int64_t lcm = 0;
+    for (auto mgmt : mgmts) {
+        if (mgmt->isTransmitting()) {
+            int64_t interval = mgmt->getBeaconInterval().raw();
+            lcm = lcm == 0 ? interval : std::lcm(lcm, interval);
+        }
+    }
+    return SimTime().setRaw(lcm);
+}
+
+simtime_t RidFastForward::computeEndTime() const
+{
+    if (until >= SIMTIME_ZERO) {
+        return until;
+    }
+    const char *limit = getEnvir()->getConfig()->getConfigValue("sim-time-limit");
+    if (limit == nullptr) {
+        throw cRuntimeError("Fast-forward needs either the until parameter or sim-time-limit");
+    }
+    return SimTime::parse(limit);
+}
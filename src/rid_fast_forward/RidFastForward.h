@@ -0,0 +1,45 @@
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+//
+
+#ifndef __RID_FAST_FORWARD_H
+#define __RID_FAST_FORWARD_H
+
+#include "inet/common/INETDefs.h"
+
+#include "rid_beacon/RidBeaconMgmt.h"
+
+using namespace inet;
+
+class RidFastForward : public cSimpleModule
+{
+  protected:
+    bool enabled;
+    simtime_t warmup;
+    simtime_t until;
+    double rssiStddev;
+
+    std::vector<RidBeaconMgmt *> mgmts;
+    simtime_t hyperperiod;
+    cMessage *captureStartMsg = nullptr;
+    cMessage *captureEndMsg = nullptr;
+
+  public:
+    virtual ~RidFastForward();
+
+  protected:
+    virtual int numInitStages() const override { return NUM_INIT_STAGES; }
+    virtual void initialize(int stage) override;
+    virtual void handleMessage(cMessage *msg) override;
+
+    /** Utility function: true if no host running Remote ID is moving */
+    virtual bool isStatic() const;
+
+    /** Utility function: least common multiple of all beacon intervals, zero if nobody transmits */
+    virtual simtime_t computeHyperperiod() const;
+
+    /** Utility function: end of the simulation from the until parameter or sim-time-limit */
+    virtual simtime_t computeEndTime() const;
+};
+
+#endif
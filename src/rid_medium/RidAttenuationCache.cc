@@ -0,0 +1,77 @@
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+//
+
+#include "RidAttenuationCache.h"
+
+#include <cmath>
+
+void RidAttenuationCache::setTolerances(double positionTolerance, double orientationTolerance)
+{
+    this->positionTolerance = positionTolerance;
+    this->orientationTolerance = orientationTolerance;
+    entries.clear();
+}
+
+double RidAttenuationCache::computeAngle(const Quaternion& q1, const Quaternion& q2)
+{
+    // angle of the rotation taking q1 to q2, both assumed to be unit quaternions
+    double dot = std::abs(q1.s * q2.s + q1.v * q2.v);
+    return 2 * std::acos(std::min(dot, 1.0));
+}
+
+bool RidAttenuationCache::isWithinTolerance(const Geometry& cached, const Geometry& current) const
+{
+    return cached.transmitterPosition.distance(current.transmitterPosition) <= positionTolerance &&
+           cached.receiverPosition.distance(current.receiverPosition) <= positionTolerance &&
+           computeAngle(cached.transmitterOrientation, current.transmitterOrientation) <= orientationTolerance &&
+           computeAngle(cached.receiverOrientation, current.receiverOrientation) <= orientationTolerance;
+}
+
+bool RidAttenuationCache::lookup(int transmitterId, int receiverId, double frequency, const Geometry& geometry, double& attenuation)
+{
+    auto it = entries.find(Key{transmitterId, receiverId, frequency});
+    if (it == entries.end()) {
+        missCount++;
+        return false;
+    }
+    if (!isWithinTolerance(it->second.geometry, geometry)) {
+        // one of the hosts moved too far, the entry is recomputed by the caller
+        entries.erase(it);
+        invalidationCount++;
+        missCount++;
+        return false;
+    }
+    hitCount++;
+    attenuation = it->second.attenuation;
+    return true;
+}
+
+void RidAttenuationCache::store(int transmitterId, int receiverId, double frequency, const Geometry& geometry, double attenuation)
+{
+    entries[Key{transmitterId, receiverId, frequency}] = Entry{geometry, attenuation};
+}
+
+void RidAttenuationCache::invalidate(const std::unordered_set<int>& radioIds)
+{
+    for (auto it = entries.begin(); it != entries.end();) {
+        if (radioIds.count(it->first.transmitterId) > 0 || radioIds.count(it->first.receiverId) > 0) {
+            it = entries.erase(it);
+            invalidationCount++;
+        }
+        else
+            ++it;
+    }
+}
+
+void RidAttenuationCache::invalidate(int radioId)
+{
+    for (auto it = entries.begin(); it != entries.end();) {
+        if (it->first.transmitterId == radioId || it->first.receiverId == radioId) {
+            it = entries.erase(it);
+            invalidationCount++;
+        }
+        else
+            ++it;
+    }
+}
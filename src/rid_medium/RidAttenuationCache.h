@@ -0,0 +1,92 @@
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+//
+
+#ifndef __RID_ATTENUATION_CACHE_H
+#define __RID_ATTENUATION_CACHE_H
+
+#include "inet/common/geometry/common/Coord.h"
+#include "inet/common/geometry/common/Quaternion.h"
+
+#include <unordered_map>
+#include <unordered_set>
+
+using namespace inet;
+
+//
+// Caches the attenuation (antenna gains, path loss and obstacle loss) between
+// pairs of radios. An entry remembers the geometry it was computed for and is
+// reused as long as neither end moved or turned beyond the configured
+// tolerances, so repeated beacons between static hosts become table lookups.
+//
+class RidAttenuationCache
+{
+  public:
+    struct Geometry {
+        Coord transmitterPosition;
+        Quaternion transmitterOrientation;
+        Coord receiverPosition;
+        Quaternion receiverOrientation;
+    };
+
+  protected:
+    struct Key {
+        int transmitterId;
+        int receiverId;
+        double frequency;
+
+        bool operator==(const Key& other) const {
+            return transmitterId == other.transmitterId && receiverId == other.receiverId && frequency == other.frequency;
+        }
+    };
+
+    struct KeyHash {
+        size_t operator()(const Key& key) const {
+            size_t h = std::hash<int>()(key.transmitterId);
+            h = h * 31 + std::hash<int>()(key.receiverId);
+            h = h * 31 + std::hash<double>()(key.frequency);
+            return h;
+        }
+    };
+
+    struct Entry {
+        Geometry geometry;
+        double attenuation;
+    };
+
+    // distance in meters either end may move before an entry is recomputed
+    double positionTolerance = 0;
+    // angle in radians either end may turn before an entry is recomputed
+    double orientationTolerance = 0;
+
+    std::unordered_map<Key, Entry, KeyHash> entries;
+
+    long hitCount = 0;
+    long missCount = 0;
+    long invalidationCount = 0;
+
+    bool isWithinTolerance(const Geometry& cached, const Geometry& current) const;
+    static double computeAngle(const Quaternion& q1, const Quaternion& q2);
+
+  public:
+    void setTolerances(double positionTolerance, double orientationTolerance);
+
+    /** Returns true and sets attenuation if a valid entry exists for the pair */
+    bool lookup(int transmitterId, int receiverId, double frequency, const Geometry& geometry, double& attenuation);
+
+    /** Stores the attenuation computed for the pair at the given geometry */
+    void store(int transmitterId, int receiverId, double frequency, const Geometry& geometry, double attenuation);
+
+    /** Drops every entry involving the given radio */
+    void invalidate(int radioId);
+    /** Drops every entry involving any of the given radios in a single pass */
+    void invalidate(const std::unordered_set<int>& radioIds);
+    void clear() { entries.clear(); }
+
+    size_t getNumEntries() const { return entries.size(); }
+    long getHitCount() const { return hitCount; }
+    long getMissCount() const { return missCount; }
+    long getInvalidationCount() const { return invalidationCount; }
+};
+
+#endif
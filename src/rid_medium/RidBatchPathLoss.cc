@@ -0,0 +1,202 @@
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+//
+
+#include "RidBatchPathLoss.h"
+
+#include <cmath>
+#include <stdexcept>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define RID_BATCH_X86
+#include <immintrin.h>
+#endif
+
+// NOTE: the scalar and vector paths must perform the same operations in the
+// same order, so products must not be contracted into FMAs by the compiler
+#if defined(__clang__)
+#pragma STDC FP_CONTRACT OFF
+#elif defined(__GNUC__)
+#pragma GCC optimize("fp-contract=off")
+#endif
+
+RidBatchPathLoss::RidBatchPathLoss(Model model, double alpha, double systemLoss, double d0) :
+    model(model), alpha(alpha), systemLoss(systemLoss), d0(d0)
+{
+    if (alpha <= 0)
+        throw std::invalid_argument("path loss exponent must be positive");
+    if (systemLoss <= 0 || d0 <= 0)
+        throw std::invalid_argument("system loss and reference distance must be positive");
+    halfAlpha = (alpha == std::floor(alpha) && (long)alpha % 2 == 0) ? (int)alpha / 2 : 0;
+    isa = detectIsa();
+}
+
+RidBatchPathLoss::Isa RidBatchPathLoss::detectIsa()
+{
+#ifdef RID_BATCH_X86
+    if (__builtin_cpu_supports("avx512f"))
+        return AVX512;
+    if (__builtin_cpu_supports("avx2"))
+        return AVX2;
+#endif
+    return SCALAR;
+}
+
+void RidBatchPathLoss::setIsa(Isa isa)
+{
+    if (isa > detectIsa())
+        throw std::invalid_argument("instruction set not supported by this CPU");
+    this->isa = isa;
+}
+
+double RidBatchPathLoss::computeScale(double waveLength) const
+{
+    switch (model) {
+        case FREE_SPACE:
+            return waveLength * waveLength / (16 * M_PI * M_PI * systemLoss);
+        case LOG_DISTANCE: {
+            double referenceLoss = waveLength / (4 * M_PI * d0);
+            return referenceLoss * referenceLoss * std::pow(d0, alpha) / systemLoss;
+        }
+        default:
+            throw std::invalid_argument("unknown path loss model");
+    }
+}
+
+void RidBatchPathLoss::computeScalar(const Transmitter& tx, const Receivers& rx, size_t begin, double scale, double *distance, double *loss, double *power) const
+{
+    for (size_t i = begin; i < rx.size; i++) {
+        double dx = rx.x[i] - tx.x;
+        double dy = rx.y[i] - tx.y;
+        double dz = rx.z[i] - tx.z;
+        double xx = dx * dx;
+        double yy = dy * dy;
+        double zz = dz * dz;
+        double d2 = xx + yy;
+        d2 = d2 + zz;
+        double d = std::sqrt(d2);
+        double l;
+        if (d2 == 0)
+            l = 1;
+        else if (halfAlpha > 0) {
+            double denominator = d2;
+            for (int m = 1; m < halfAlpha; m++)
+                denominator = denominator * d2;
+            l = scale / denominator;
+        }
+        else
+            l = scale / std::pow(d, alpha);
+        if (distance)
+            distance[i] = d;
+        if (loss)
+            loss[i] = l;
+        if (power) {
+            double p = tx.power * l;
+            if (rx.gain)
+                p = p * rx.gain[i];
+            power[i] = p;
+        }
+    }
+}
+
+#ifdef RID_BATCH_X86
+
+__attribute__((target("avx2")))
+size_t RidBatchPathLoss::computeAvx2(const Transmitter& tx, const Receivers& rx, double scale, double *distance, double *loss, double *power) const
+{
+    const size_t n = rx.size - rx.size % 4;
+    const __m256d txX = _mm256_set1_pd(tx.x);
+    const __m256d txY = _mm256_set1_pd(tx.y);
+    const __m256d txZ = _mm256_set1_pd(tx.z);
+    const __m256d txPower = _mm256_set1_pd(tx.power);
+    const __m256d k = _mm256_set1_pd(scale);
+    const __m256d zero = _mm256_setzero_pd();
+    const __m256d one = _mm256_set1_pd(1.0);
+    for (size_t i = 0; i < n; i += 4) {
+        __m256d dx = _mm256_sub_pd(_mm256_loadu_pd(rx.x + i), txX);
+        __m256d dy = _mm256_sub_pd(_mm256_loadu_pd(rx.y + i), txY);
+        __m256d dz = _mm256_sub_pd(_mm256_loadu_pd(rx.z + i), txZ);
+        __m256d d2 = _mm256_add_pd(_mm256_mul_pd(dx, dx), _mm256_mul_pd(dy, dy));
+        d2 = _mm256_add_pd(d2, _mm256_mul_pd(dz, dz));
+        __m256d denominator = d2;
+        for (int m = 1; m < halfAlpha; m++)
+            denominator = _mm256_mul_pd(denominator, d2);
+        __m256d l = _mm256_div_pd(k, denominator);
+        l = _mm256_blendv_pd(l, one, _mm256_cmp_pd(d2, zero, _CMP_EQ_OQ));
+        if (distance)
+            _mm256_storeu_pd(distance + i, _mm256_sqrt_pd(d2));
+        if (loss)
+            _mm256_storeu_pd(loss + i, l);
+        if (power) {
+            __m256d p = _mm256_mul_pd(txPower, l);
+            if (rx.gain)
+                p = _mm256_mul_pd(p, _mm256_loadu_pd(rx.gain + i));
+            _mm256_storeu_pd(power + i, p);
+        }
+    }
+    return n;
+}
+
+__attribute__((target("avx512f")))
+size_t RidBatchPathLoss::computeAvx512(const Transmitter& tx, const Receivers& rx, double scale, double *distance, double *loss, double *power) const
+{
+    const size_t n = rx.size - rx.size % 8;
+    const __m512d txX = _mm512_set1_pd(tx.x);
+    const __m512d txY = _mm512_set1_pd(tx.y);
+    const __m512d txZ = _mm512_set1_pd(tx.z);
+    const __m512d txPower = _mm512_set1_pd(tx.power);
+    const __m512d k = _mm512_set1_pd(scale);
+    const __m512d zero = _mm512_setzero_pd();
+    const __m512d one = _mm512_set1_pd(1.0);
+    for (size_t i = 0; i < n; i += 8) {
+        __m512d dx = _mm512_sub_pd(_mm512_loadu_pd(rx.x + i), txX);
+        __m512d dy = _mm512_sub_pd(_mm512_loadu_pd(rx.y + i), txY);
+        __m512d dz = _mm512_sub_pd(_mm512_loadu_pd(rx.z + i), txZ);
+        __m512d d2 = _mm512_add_pd(_mm512_mul_pd(dx, dx), _mm512_mul_pd(dy, dy));
+        d2 = _mm512_add_pd(d2, _mm512_mul_pd(dz, dz));
+        __m512d denominator = d2;
+        for (int m = 1; m < halfAlpha; m++)
+            denominator = _mm512_mul_pd(denominator, d2);
+        __m512d l = _mm512_div_pd(k, denominator);
+        l = _mm512_mask_blend_pd(_mm512_cmp_pd_mask(d2, zero, _CMP_EQ_OQ), l, one);
+        if (distance)
+            _mm512_storeu_pd(distance + i, _mm512_sqrt_pd(d2));
+        if (loss)
+            _mm512_storeu_pd(loss + i, l);
+        if (power) {
+            __m512d p = _mm512_mul_pd(txPower, l);
+            if (rx.gain)
+                p = _mm512_mul_pd(p, _mm512_loadu_pd(rx.gain + i));
+            _mm512_storeu_pd(power + i, p);
+        }
+    }
+    return n;
+}
+
+#else
+
+size_t RidBatchPathLoss::computeAvx2(const Transmitter& tx, const Receivers& rx, double scale, double *distance, double *loss, double *power) const
+{
+    return 0;
+}
+
+size_t RidBatchPathLoss::computeAvx512(const Transmitter& tx, const Receivers& rx, double scale, double *distance, double *loss, double *power) const
+{
+    return 0;
+}
+
+#endif
+
+void RidBatchPathLoss::compute(const Transmitter& tx, const Receivers& rx, double *distance, double *loss, double *power) const
+{
+    double scale = computeScale(tx.waveLength);
+    size_t done = 0;
+    // exponents that are not even integers need pow() which has no vector counterpart here
+    if (halfAlpha > 0) {
+        if (isa == AVX512)
+            done = computeAvx512(tx, rx, scale, distance, loss, power);
+        else if (isa == AVX2)
+            done = computeAvx2(tx, rx, scale, distance, loss, power);
+    }
+    computeScalar(tx, rx, done, scale, distance, loss, power);
+}
@@ -0,0 +1,90 @@
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+//
+
+#ifndef __RID_BATCH_PATH_LOSS_H
+#define __RID_BATCH_PATH_LOSS_H
+
+#include <cstddef>
+
+//
+// Computes distance, path loss and received power from one transmitter to
+// many receivers at once. Receiver positions are passed as separate x/y/z
+// arrays (structure of arrays) so that AVX2 and AVX-512 lanes can process
+// 4 or 8 receivers per instruction. Every lane performs exactly the same
+// IEEE operations as the scalar fallback, so results are bit-identical
+// whichever path runs.
+//
+// Both supported models reduce to loss = k / d^alpha:
+//  - free space (as in INET's FreeSpacePathLoss):
+//      k = lambda^2 / (16 * pi^2 * systemLoss)
+//  - log-distance (as in INET's LogDistancePathLoss):
+//      k = (lambda / (4 * pi * d0))^2 * d0^alpha / systemLoss
+// Even integer path loss exponents are computed from the squared distance
+// without pow(), other exponents use the scalar path only.
+//
+class RidBatchPathLoss
+{
+  public:
+    enum Model {
+        FREE_SPACE,
+        LOG_DISTANCE,
+    };
+
+    struct Transmitter {
+        double x;
+        double y;
+        double z;
+        // total transmission power in watts
+        double power;
+        // wave length of the center frequency in meters
+        double waveLength;
+    };
+
+    struct Receivers {
+        size_t size;
+        const double *x;
+        const double *y;
+        const double *z;
+        // optional combined antenna gain per receiver, nullptr means isotropic
+        const double *gain = nullptr;
+    };
+
+    enum Isa {
+        SCALAR,
+        AVX2,
+        AVX512,
+    };
+
+  protected:
+    Model model;
+    double alpha;
+    double systemLoss;
+    double d0;
+    // alpha / 2 if alpha is an even integer, otherwise 0
+    int halfAlpha;
+    Isa isa;
+
+    double computeScale(double waveLength) const;
+
+    void computeScalar(const Transmitter& tx, const Receivers& rx, size_t begin, double scale, double *distance, double *loss, double *power) const;
+    size_t computeAvx2(const Transmitter& tx, const Receivers& rx, double scale, double *distance, double *loss, double *power) const;
+    size_t computeAvx512(const Transmitter& tx, const Receivers& rx, double scale, double *distance, double *loss, double *power) const;
+
+  public:
+    /** systemLoss is a linear factor (>= 1), d0 is only used by LOG_DISTANCE */
+    RidBatchPathLoss(Model model, double alpha, double systemLoss, double d0 = 1);
+
+    /** Restricts the instruction set, e.g. to compare against the scalar path */
+    void setIsa(Isa isa);
+    Isa getIsa() const { return isa; }
+    static Isa detectIsa();
+
+    /**
+     * Fills the output arrays (each rx.size long) for all receivers. Any of
+     * the output pointers may be nullptr if the caller is not interested.
+     */
+    void compute(const Transmitter& tx, const Receivers& rx, double *distance, double *loss, double *power) const;
+};
+
+#endif
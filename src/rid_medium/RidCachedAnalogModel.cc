@@ -0,0 +1,91 @@
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+//
+// Based on inet/physicallayer/wireless/common/analogmodel/dimensional/DimensionalMediumAnalogModel.cc
+//
+
+#include "RidCachedAnalogModel.h"
+#include "RidRadioMedium.h"
+
+#include "inet/physicallayer/wireless/common/contract/packetlevel/IRadioMedium.h"
+
+Define_Module(RidCachedAnalogModel);
+
+void RidCachedAnalogModel::initialize(int stage)
+{
+    DimensionalMediumAnalogModel::initialize(stage);
+
+    if (stage == INITSTAGE_LOCAL) {
+        cacheEnabled = par("cacheEnabled");
+        double positionTolerance = par("positionTolerance");
+        double orientationTolerance = par("orientationTolerance").doubleValueInUnit("rad");
+        attenuationCache.setTolerances(positionTolerance, orientationTolerance);
+    }
+}
+
+void RidCachedAnalogModel::finish()
+{
+    recordScalar("attenuation cache hits", attenuationCache.getHitCount());
+    recordScalar("attenuation cache misses", attenuationCache.getMissCount());
+    recordScalar("attenuation cache invalidations", attenuationCache.getInvalidationCount());
+    recordScalar("attenuation cache entries", attenuationCache.getNumEntries());
+}
+
+void RidCachedAnalogModel::invalidateRadios(const std::unordered_set<int>& radioIds)
+{
+    std::lock_guard<std::mutex> lock(attenuationCacheMutex);
+    attenuationCache.invalidate(radioIds);
+}
+
+double RidCachedAnalogModel::computeAttenuation(const IRadio *receiverRadio, const ITransmission *transmission, const IArrival *arrival, Hz centerFrequency) const
+{
+    const IRadioMedium *radioMedium = receiverRadio->getMedium();
+    const Coord& transmissionStartPosition = transmission->getStartPosition();
+    const Coord& receptionStartPosition = arrival->getStartPosition();
+    double transmitterAntennaGain = computeAntennaGain(transmission->getTransmitterAntennaGain(), transmissionStartPosition, receptionStartPosition, transmission->getStartOrientation());
+    double receiverAntennaGain = computeAntennaGain(receiverRadio->getAntenna()->getGain().get(), receptionStartPosition, transmissionStartPosition, arrival->getStartOrientation());
+    mps propagationSpeed = radioMedium->getPropagation()->getPropagationSpeed();
+    m distance = m(transmissionStartPosition.distance(receptionStartPosition));
+    // RidRadioMedium computes the path loss of broadcasts for all receivers at once
+    double pathLoss;
+    auto ridRadioMedium = dynamic_cast<const RidRadioMedium *>(radioMedium);
+    if (ridRadioMedium == nullptr || !ridRadioMedium->findBatchPathLoss(transmission, receiverRadio, pathLoss))
+        pathLoss = radioMedium->getPathLoss()->computePathLoss(propagationSpeed, centerFrequency, distance);
+    double obstacleLoss = radioMedium->getObstacleLoss() ? radioMedium->getObstacleLoss()->computeObstacleLoss(centerFrequency, transmissionStartPosition, receptionStartPosition) : 1;
+    return std::min(1.0, transmitterAntennaGain * receiverAntennaGain * pathLoss * obstacleLoss);
+}
+
+Ptr<const IFunction<WpHz, Domain<simsec, Hz>>> RidCachedAnalogModel::computeReceptionPower(const IRadio *receiverRadio, const ITransmission *transmission, const IArrival *arrival) const
+{
+    // the attenuation is only a single scalar when it is evaluated at the center frequency
+    if (!cacheEnabled || !attenuateWithCenterFrequency)
+        return DimensionalMediumAnalogModel::computeReceptionPower(receiverRadio, transmission, arrival);
+
+    auto narrowbandSignal = check_and_cast<const INarrowbandSignal *>(transmission->getAnalogModel());
+    auto dimensionalSignal = check_and_cast<const IDimensionalSignal *>(transmission->getAnalogModel());
+    Hz centerFrequency = narrowbandSignal->getCenterFrequency();
+
+    RidAttenuationCache::Geometry geometry {
+        transmission->getStartPosition(),
+        transmission->getStartOrientation(),
+        arrival->getStartPosition(),
+        arrival->getStartOrientation()
+    };
+    double attenuation;
+    bool found;
+    {
+        std::lock_guard<std::mutex> lock(attenuationCacheMutex);
+        found = attenuationCache.lookup(transmission->getTransmitterId(), receiverRadio->getId(), centerFrequency.get(), geometry, attenuation);
+    }
+    if (!found) {
+        attenuation = computeAttenuation(receiverRadio, transmission, arrival, centerFrequency);
+        std::lock_guard<std::mutex> lock(attenuationCacheMutex);
+        attenuationCache.store(transmission->getTransmitterId(), receiverRadio->getId(), centerFrequency.get(), geometry, attenuation);
+    }
+
+    const auto& transmissionPowerFunction = dimensionalSignal->getPower();
+    Point<simsec, Hz> propagationShift(simsec(arrival->getStartTime() - transmission->getStartTime()), Hz(0));
+    const auto& propagatedTransmissionPowerFunction = makeShared<ShiftFunction<WpHz, Domain<simsec, Hz>>>(transmissionPowerFunction, propagationShift);
+    const auto& attenuationFunction = makeShared<ConstantFunction<double, Domain<simsec, Hz>>>(attenuation);
+    return propagatedTransmissionPowerFunction->multiply(attenuationFunction);
+}
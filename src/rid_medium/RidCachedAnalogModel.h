@@ -0,0 +1,41 @@
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+//
+// Based on inet/physicallayer/wireless/common/analogmodel/dimensional/DimensionalMediumAnalogModel.h
+//
+
+#ifndef __RID_CACHED_ANALOG_MODEL_H
+#define __RID_CACHED_ANALOG_MODEL_H
+
+#include "inet/physicallayer/wireless/common/analogmodel/dimensional/DimensionalMediumAnalogModel.h"
+
+#include "RidAttenuationCache.h"
+
+#include <mutex>
+
+using namespace inet;
+using namespace inet::physicallayer;
+
+class RidCachedAnalogModel : public DimensionalMediumAnalogModel
+{
+  protected:
+    bool cacheEnabled;
+    mutable RidAttenuationCache attenuationCache;
+    // RidRadioMedium may compute receptions on several threads
+    mutable std::mutex attenuationCacheMutex;
+
+  protected:
+    virtual void initialize(int stage) override;
+    virtual void finish() override;
+
+    /** Utility function: computes the attenuation between both ends at the center frequency, bypassing the cache */
+    virtual double computeAttenuation(const IRadio *receiverRadio, const ITransmission *transmission, const IArrival *arrival, Hz centerFrequency) const;
+
+  public:
+    /** Drops the cached attenuations of radios that left the medium */
+    virtual void invalidateRadios(const std::unordered_set<int>& radioIds);
+
+    virtual Ptr<const IFunction<WpHz, Domain<simsec, Hz>>> computeReceptionPower(const IRadio *receiverRadio, const ITransmission *transmission, const IArrival *arrival) const override;
+};
+
+#endif
@@ -0,0 +1,177 @@
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+//
+// Based on inet/physicallayer/wireless/common/medium/RadioMedium.cc
+//
+
+#include "RidRadioMedium.h"
+#include "RidCachedAnalogModel.h"
+
+#include "inet/physicallayer/wireless/common/pathloss/FreeSpacePathLoss.h"
+#include "inet/physicallayer/wireless/common/pathloss/LogDistancePathLoss.h"
+
+#include <algorithm>
+
+Define_Module(RidRadioMedium);
+
+RidRadioMedium::~RidRadioMedium()
+{
+    delete workerPool;
+    delete batchPathLoss;
+}
+
+void RidRadioMedium::initialize(int stage)
+{
+    RadioMedium::initialize(stage);
+
+    if (stage == INITSTAGE_LOCAL) {
+        numWorkerThreads = par("numWorkerThreads");
+        minParallelReceivers = par("minParallelReceivers");
+        if (numWorkerThreads < 0)
+            throw cRuntimeError("numWorkerThreads must not be negative");
+        if (par("batchPathLoss"))
+            batchPathLoss = createBatchPathLoss();
+        // the pool only ever runs the batch kernel, so it would sit idle without it
+        if (numWorkerThreads > 0 && batchPathLoss == nullptr)
+            throw cRuntimeError("numWorkerThreads requires batchPathLoss = true and a free space or log-distance path loss model");
+        if (numWorkerThreads > 0)
+            workerPool = new utils::WorkStealingPool(numWorkerThreads);
+    }
+}
+
+void RidRadioMedium::finish()
+{
+    RadioMedium::finish();
+    recordScalar("batch path loss fan-outs", batchFanOutCount);
+    recordScalar("parallel batch path loss fan-outs", parallelFanOutCount);
+}
+
+RidBatchPathLoss *RidRadioMedium::createBatchPathLoss() const
+{
+    auto module = check_and_cast<const cModule *>(pathLoss);
+    double systemLoss = module->hasPar("systemLoss") ? math::dB2fraction(module->par("systemLoss").doubleValue()) : 1;
+    // check the derived model first in case it extends the free space one
+    if (dynamic_cast<const LogDistancePathLoss *>(pathLoss) != nullptr)
+        return new RidBatchPathLoss(RidBatchPathLoss::LOG_DISTANCE, module->par("alpha"), systemLoss, m(module->par("d0")).get());
+    else if (dynamic_cast<const FreeSpacePathLoss *>(pathLoss) != nullptr)
+        return new RidBatchPathLoss(RidBatchPathLoss::FREE_SPACE, module->par("alpha"), systemLoss);
+    else {
+        EV_WARN << "Path loss model " << module->getNedTypeName() << " is not supported by the batch kernel" << endl;
+        return nullptr;
+    }
+}
+
+bool RidRadioMedium::findBatchPathLoss(const ITransmission *transmission, const IRadio *receiverRadio, double& pathLoss) const
+{
+    auto it = batchPathLossByTransmission.find(transmission->getId());
+    if (it == batchPathLossByTransmission.end())
+        return false;
+    auto jt = it->second.find(receiverRadio->getId());
+    if (jt == it->second.end())
+        return false;
+    pathLoss = jt->second;
+    return true;
+}
+
+void RidRadioMedium::removeRadio(const IRadio *radio)
+{
+    removedRadioIds.insert(radio->getId());
+    RadioMedium::removeRadio(radio);
+    // hosts are often removed in bulk, so purge once they are all gone rather than once per radio
+    if (removedRadioIds.size() >= 64)
+        purgeRemovedRadios();
+}
+
+void RidRadioMedium::purgeRemovedRadios()
+{
+    if (removedRadioIds.empty())
+        return;
+    if (auto cachedAnalogModel = dynamic_cast<RidCachedAnalogModel *>(const_cast<IAnalogModel *>(analogModel)))
+        cachedAnalogModel->invalidateRadios(removedRadioIds);
+    removedRadioIds.clear();
+}
+
+void RidRadioMedium::addTransmission(const IRadio *transmitterRadio, const ITransmission *transmission)
+{
+    purgeRemovedRadios();
+    RadioMedium::addTransmission(transmitterRadio, transmission);
+
+    if (batchPathLoss == nullptr)
+        return;
+
+    FanOut fanOut;
+    collectReceivers(transmitterRadio, transmission, fanOut);
+    computeBatchPathLoss(transmission, fanOut);
+}
+
+void RidRadioMedium::removeTransmission(const ITransmission *transmission)
+{
+    batchPathLossByTransmission.erase(transmission->getId());
+    RadioMedium::removeTransmission(transmission);
+}
+
+void RidRadioMedium::collectReceivers(const IRadio *transmitterRadio, const ITransmission *transmission, FanOut& fanOut) const
+{
+    communicationCache->mapRadios([&] (const IRadio *receiverRadio) {
+        if (receiverRadio == nullptr || receiverRadio == transmitterRadio)
+            return;
+        const IArrival *arrival = communicationCache->getCachedArrival(receiverRadio, transmission);
+        if (arrival == nullptr)
+            return;
+        fanOut.receivers.push_back(receiverRadio);
+        fanOut.arrivals.push_back(arrival);
+    });
+}
+
+void RidRadioMedium::computeBatchPathLoss(const ITransmission *transmission, const FanOut& fanOut)
+{
+    size_t size = fanOut.receivers.size();
+    if (size == 0)
+        return;
+
+    // everything the kernel needs is gathered here on the event thread: INET objects and their
+    // reference counts are not thread safe, so the workers only ever see these plain arrays
+    std::vector<double> x(size), y(size), z(size), gain(size), loss(size);
+    double maxTransmitterGain = transmission->getTransmitterAntennaGain()->getMaxGain();
+    for (size_t i = 0; i < size; i++) {
+        const Coord& position = fanOut.arrivals[i]->getStartPosition();
+        x[i] = position.x;
+        y[i] = position.y;
+        z[i] = position.z;
+        gain[i] = maxTransmitterGain * fanOut.receivers[i]->getAntenna()->getGain()->getMaxGain();
+    }
+
+    auto narrowbandSignal = check_and_cast<const INarrowbandSignal *>(transmission->getAnalogModel());
+    auto dimensionalSignal = check_and_cast<const IDimensionalSignal *>(transmission->getAnalogModel());
+    const Coord& transmitterPosition = transmission->getStartPosition();
+    RidBatchPathLoss::Transmitter tx;
+    tx.x = transmitterPosition.x;
+    tx.y = transmitterPosition.y;
+    tx.z = transmitterPosition.z;
+    tx.power = (dimensionalSignal->getPower()->getMax() * narrowbandSignal->getBandwidth()).get();
+    tx.waveLength = (propagation->getPropagationSpeed() / narrowbandSignal->getCenterFrequency()).get();
+    auto computeChunk = [&] (size_t begin, size_t end) {
+        RidBatchPathLoss::Receivers rx;
+        rx.size = end - begin;
+        rx.x = x.data() + begin;
+        rx.y = y.data() + begin;
+        rx.z = z.data() + begin;
+        rx.gain = gain.data() + begin;
+        batchPathLoss->compute(tx, rx, nullptr, loss.data() + begin, nullptr);
+    };
+    if (workerPool != nullptr && (int)size >= minParallelReceivers) {
+        // chunks are multiples of the widest vector so every lane stays full
+        const size_t chunkSize = 256;
+        workerPool->parallelFor((size + chunkSize - 1) / chunkSize, [&] (size_t chunk) {
+            computeChunk(chunk * chunkSize, std::min(size, (chunk + 1) * chunkSize));
+        });
+        parallelFanOutCount++;
+    }
+    else
+        computeChunk(0, size);
+
+    auto& pathLossByReceiver = batchPathLossByTransmission[transmission->getId()];
+    for (size_t i = 0; i < size; i++)
+        pathLossByReceiver[fanOut.receivers[i]->getId()] = loss[i];
+    batchFanOutCount++;
+}
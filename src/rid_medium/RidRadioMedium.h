@@ -0,0 +1,73 @@
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+//
+// Based on inet/physicallayer/wireless/common/medium/RadioMedium.h
+//
+
+#ifndef __RID_RADIO_MEDIUM_H
+#define __RID_RADIO_MEDIUM_H
+
+#include "inet/physicallayer/wireless/common/medium/RadioMedium.h"
+
+#include "RidBatchPathLoss.h"
+#include "utils/work_stealing_pool.h"
+
+#include <unordered_map>
+#include <unordered_set>
+
+using namespace inet;
+using namespace inet::physicallayer;
+
+class RidRadioMedium : public RadioMedium
+{
+  protected:
+    int numWorkerThreads;
+    int minParallelReceivers;
+    utils::WorkStealingPool *workerPool = nullptr;
+
+    // set if the path loss model is supported by the batch kernel
+    RidBatchPathLoss *batchPathLoss = nullptr;
+    // path loss of each receiver (by radio id) for each transmission (by id) still in the medium
+    std::unordered_map<int, std::unordered_map<int, double>> batchPathLossByTransmission;
+
+    // radios removed since the attenuation cache was last purged; module ids are never reused,
+    // so their entries are only dead weight and can be dropped in one pass later
+    std::unordered_set<int> removedRadioIds;
+
+    long parallelFanOutCount = 0;
+    long batchFanOutCount = 0;
+
+    struct FanOut {
+        std::vector<const IRadio *> receivers;
+        std::vector<const IArrival *> arrivals;
+    };
+
+  public:
+    virtual ~RidRadioMedium();
+
+    /** Returns true and sets pathLoss if the batch kernel already computed it for this pair */
+    virtual bool findBatchPathLoss(const ITransmission *transmission, const IRadio *receiverRadio, double& pathLoss) const;
+
+    virtual void removeRadio(const IRadio *radio) override;
+
+  protected:
+    virtual void initialize(int stage) override;
+    virtual void finish() override;
+
+    virtual void addTransmission(const IRadio *transmitterRadio, const ITransmission *transmission) override;
+    virtual void removeTransmission(const ITransmission *transmission) override;
+
+    /** Utility function: drops the cached attenuations of the removed radios */
+    virtual void purgeRemovedRadios();
+
+    /** Utility function: creates the batch kernel matching the configured path loss model, if any */
+    virtual RidBatchPathLoss *createBatchPathLoss() const;
+
+    /** Utility function: collects the receivers of a new transmission in radio order */
+    virtual void collectReceivers(const IRadio *transmitterRadio, const ITransmission *transmission, FanOut& fanOut) const;
+
+    /** Utility function: computes the path loss to all receivers with the batch kernel, split over the worker pool if large */
+    virtual void computeBatchPathLoss(const ITransmission *transmission, const FanOut& fanOut);
+};
+
+#endif
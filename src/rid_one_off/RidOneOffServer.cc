@@ -0,0 +1,207 @@
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+//
+
+#include "RidOneOffServer.h"
+
+#include "inet/common/ModuleAccess.h"
+#include "inet/physicallayer/wireless/common/contract/packetlevel/IRadioMedium.h"
+#include "inet/physicallayer/wireless/common/contract/packetlevel/SignalTag_m.h"
+
+#include "rid_beacon/RidBeaconFrame_m.h"
+#include "rid_beacon/RidBeaconMgmt.h"
+
+#include "RidOneOffRequest_m.h"
+
+using namespace inet::physicallayer;
+
+Define_Module(RidOneOffServer);
+
+RidOneOffServer::~RidOneOffServer()
+{
+    cancelAndDelete(collectMsg);
+}
+
+void RidOneOffServer::initialize(int stage)
+{
+    if (stage == INITSTAGE_LOCAL) {
+        scheduler = dynamic_cast<RidSocketScheduler *>(getSimulation()->getScheduler());
+        if (scheduler == nullptr)
+            throw cRuntimeError("RidOneOffServer requires scheduler-class = \"RidSocketScheduler\"");
+        hostType = cModuleType::get(par("hostType").stringValue());
+        collectMsg = new cMessage("collect");
+        // collect before anything else happens at the removal time
+        collectMsg->setSchedulingPriority(SHRT_MIN);
+
+        medium = getSimulation()->getModuleByPath("radioMedium");
+        if (!medium) {
+            throw cRuntimeError("radioMedium not found");
+        }
+        medium->subscribe(IRadioMedium::signalRemovedSignal, this);
+        getSystemModule()->subscribe(RidBeaconMgmt::beaconReceivedSignal, this);
+
+        if (getSystemModule()->getSubmoduleVectorSize("host") != 0)
+            throw cRuntimeError("The network must not have hosts of its own, set numHosts = 0");
+    }
+    else if (stage == INITSTAGE_LAST) {
+        scheduler->setServerModule(this, par("socketPath").stringValue());
+    }
+}
+
+void RidOneOffServer::handleMessage(cMessage *msg)
+{
+    if (msg == collectMsg) {
+        scheduler->sendReply(formatResults());
+        finishRequest();
+        return;
+    }
+
+    auto request = check_and_cast<RidOneOffRequest *>(msg);
+    std::string error;
+    utils::JsonValue json;
+    try {
+        json = utils::json_parse(request->getJson());
+        if (!json.has("shutdown"))
+            startRequest(json);
+    }
+    catch (std::exception& e) {
+        // a bad request must not take the server down
+        finishRequest();
+        error = e.what();
+    }
+    delete request;
+    if (!error.empty())
+        scheduler->sendReply("{\"error\": " + utils::json_quote(error) + "}");
+    else if (json.has("shutdown"))
+        endSimulation();
+}
+
+void RidOneOffServer::startRequest(const utils::JsonValue& request)
+{
+    // RID fields are validated like rid-one-off.sh does, which does not apply them either
+    const utils::JsonValue& rid = request["rid"];
+    for (const char *field : {"n", "t", "x", "y", "z", "v", "g", "h"})
+        rid[field].asDouble();
+
+    const utils::JsonValue& tuples = request["drones"];
+    if (tuples.size() == 0)
+        throw cRuntimeError("Provide at least one drone tuple");
+    std::vector<Drone> drones;
+    for (size_t i = 0; i < tuples.size(); i++) {
+        const utils::JsonValue& tuple = tuples[i];
+        if (tuple.size() != 7)
+            throw cRuntimeError("Invalid tuple %d (need 7 values)", (int)i);
+        drones.push_back({tuple[0].asInt(), tuple[1].asDouble(), tuple[2].asDouble(), tuple[3].asDouble(),
+                          tuple[4].asDouble(), tuple[5].asDouble(), tuple[6].asDouble()});
+    }
+
+    EV_INFO << "Running one-off request with " << drones.size() << " drones" << endl;
+    serving = true;
+    requestStart = simTime();
+    cModule *network = getSystemModule();
+    network->setSubmoduleVectorSize("host", drones.size());
+    for (size_t i = 0; i < drones.size(); i++) {
+        hostMap.push_back(drones[i].serialNumber);
+        createHost(i, drones[i], i == 0);
+    }
+}
+
+void RidOneOffServer::createHost(int index, const Drone& drone, bool transmitter)
+{
+    cModule *network = getSystemModule();
+    cModule *host = hostType->create("host", network, index);
+    host->finalizeParameters();
+    host->buildInside();
+
+    cModule *mobility = host->getSubmodule("mobility");
+    mobility->par("initialX").setValue(cValue(drone.x, "m"));
+    mobility->par("initialY").setValue(cValue(drone.y, "m"));
+    mobility->par("initialZ").setValue(cValue(drone.z, "m"));
+    mobility->par("speed").setValue(cValue(drone.speed, "mps"));
+    mobility->par("initialMovementHeading").setValue(cValue(drone.heading, "deg"));
+    mobility->par("initialMovementElevation").setValue(cValue(drone.elevation, "deg"));
+
+    cModule *mgmt = host->getModuleByPath(".wlan[0].mgmt");
+    mgmt->par("serialNumber").setIntValue(drone.serialNumber);
+    mgmt->par("startupJitter").setValue(cValue(0, "s"));
+    mgmt->par("transmitBeacon").setBoolValue(transmitter);
+    // the server collects after the first transmission instead of ending the simulation
+    mgmt->par("oneOff").setBoolValue(false);
+
+    host->callInitialize();
+}
+
+void RidOneOffServer::finishRequest()
+{
+    cancelEvent(collectMsg);
+    cModule *network = getSystemModule();
+    for (int i = 0; i < network->getSubmoduleVectorSize("host"); i++) {
+        if (cModule *host = network->getSubmodule("host", i))
+            host->deleteModule();
+    }
+    network->setSubmoduleVectorSize("host", 0);
+    serving = false;
+    hostMap.clear();
+    serialNumbers.clear();
+    receptionPowers.clear();
+}
+
+void RidOneOffServer::receiveSignal(cComponent *source, simsignal_t signalID, cObject *obj, cObject *details)
+{
+    if (!serving)
+        return;
+
+    if (signalID == IRadioMedium::signalRemovedSignal) {
+        // the transmitter sends only once before the collection
+        if (!collectMsg->isScheduled()) {
+            Enter_Method_Silent();
+            scheduleAt(simTime(), collectMsg);
+        }
+    }
+    else if (signalID == RidBeaconMgmt::beaconReceivedSignal) {
+        auto packet = check_and_cast<Packet *>(obj);
+        int hostIndex = getContainingNode(check_and_cast<cModule *>(source))->getIndex();
+        simtime_t time = simTime() - requestStart;
+
+        auto beaconBody = packet->peekAtFront<RidBeaconFrame>();
+        Series& serial = serialNumbers[hostIndex];
+        serial.times.push_back(time);
+        serial.values.push_back(beaconBody->getSerialNumber());
+
+        auto signalPowerInd = packet->findTag<SignalPowerInd>();
+        if (signalPowerInd != nullptr) {
+            Series& power = receptionPowers[hostIndex];
+            power.times.push_back(time);
+            power.values.push_back(10 * std::log10(signalPowerInd->getPower().get() * 1000));
+        }
+    }
+}
+
+std::string RidOneOffServer::formatSeries(const std::map<int, Series>& seriesByHost, const std::vector<int>& hostMap)
+{
+    // values are strings like in the CSV that rid-csv-extract.py reads
+    std::string result = "{";
+    for (auto& [hostIndex, series] : seriesByHost) {
+        if (result.size() > 1)
+            result += ", ";
+        result += utils::json_quote(std::to_string(hostMap.at(hostIndex))) + ": {\"times\": [";
+        for (size_t i = 0; i < series.times.size(); i++)
+            result += (i ? ", " : "") + utils::json_quote(series.times[i].str());
+        result += "], \"values\": [";
+        for (size_t i = 0; i < series.values.size(); i++)
+            result += (i ? ", " : "") + utils::json_quote(utils::json_number(series.values[i]));
+        result += "]}";
+    }
+    return result + "}";
+}
+
+std::string RidOneOffServer::formatResults() const
+{
+    // like rid-csv-extract.py, nothing at all if nobody received the beacon
+    if (serialNumbers.empty())
+        return "{}";
+    std::string result = "{\"Serial Number\": " + formatSeries(serialNumbers, hostMap);
+    if (!receptionPowers.empty())
+        result += ", \"Reception Power\": " + formatSeries(receptionPowers, hostMap);
+    return result + "}";
+}
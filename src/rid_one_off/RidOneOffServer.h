@@ -0,0 +1,72 @@
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+//
+
+#ifndef __RID_ONE_OFF_SERVER_H
+#define __RID_ONE_OFF_SERVER_H
+
+#include "inet/common/INETDefs.h"
+
+#include "utils/json.h"
+
+#include "RidSocketScheduler.h"
+
+using namespace inet;
+
+class RidOneOffServer : public cSimpleModule, protected cListener
+{
+  public:
+    /** values recorded for one host, in the order of their times */
+    struct Series {
+        std::vector<simtime_t> times;
+        std::vector<double> values;
+    };
+
+  protected:
+    struct Drone {
+        int serialNumber;
+        double x, y, z;
+        double speed;
+        double heading;
+        double elevation;
+    };
+
+    RidSocketScheduler *scheduler = nullptr;
+    cModuleType *hostType = nullptr;
+    cModule *medium = nullptr;
+
+    // state of the request being served
+    bool serving = false;
+    simtime_t requestStart;
+    std::vector<int> hostMap;
+    std::map<int, Series> serialNumbers;
+    std::map<int, Series> receptionPowers;
+    cMessage *collectMsg = nullptr;
+
+  public:
+    virtual ~RidOneOffServer();
+
+    /** Utility function: one metric of the reply, keyed by the serial number hostMap gives each host index */
+    static std::string formatSeries(const std::map<int, Series>& seriesByHost, const std::vector<int>& hostMap);
+
+  protected:
+    virtual int numInitStages() const override { return NUM_INIT_STAGES; }
+    virtual void initialize(int stage) override;
+    virtual void handleMessage(cMessage *msg) override;
+
+    virtual void receiveSignal(cComponent *source, simsignal_t signalID, cObject *obj, cObject *details) override;
+
+    /** Utility function: validates a request and starts its scenario, throws on malformed requests */
+    virtual void startRequest(const utils::JsonValue& request);
+
+    /** Utility function: creates and initializes the host at the given index of the host vector */
+    virtual void createHost(int index, const Drone& drone, bool transmitter);
+
+    /** Utility function: deletes all hosts and forgets the request */
+    virtual void finishRequest();
+
+    /** Utility function: reply in the format of rid-csv-extract.py */
+    virtual std::string formatResults() const;
+};
+
+#endif
@@ -0,0 +1,171 @@
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+//
+// Based on samples/sockets/cSocketRTScheduler.cc from OMNeT++
+//
+
+#include "RidSocketScheduler.h"
+
+#include "RidOneOffRequest_m.h"
+
+#include <cerrno>
+#include <cstring>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+Register_Class(RidSocketScheduler);
+
+RidSocketScheduler::~RidSocketScheduler()
+{
+    closeConnection();
+    if (listenerFd >= 0) {
+        close(listenerFd);
+        unlink(socketPath.c_str());
+    }
+}
+
+std::string RidSocketScheduler::str() const
+{
+    return "Remote ID one-off server scheduler (" + socketPath + ")";
+}
+
+void RidSocketScheduler::setServerModule(cModule *module, const char *socketPath)
+{
+    if (serverModule != nullptr)
+        throw cRuntimeError("RidSocketScheduler: only one server module is supported");
+    serverModule = module;
+    this->socketPath = socketPath;
+    setupListener();
+}
+
+void RidSocketScheduler::startRun()
+{
+}
+
+void RidSocketScheduler::endRun()
+{
+    closeConnection();
+    if (listenerFd >= 0) {
+        close(listenerFd);
+        listenerFd = -1;
+        unlink(socketPath.c_str());
+    }
+}
+
+void RidSocketScheduler::setupListener()
+{
+    sockaddr_un address = {};
+    if (socketPath.size() >= sizeof(address.sun_path))
+        throw cRuntimeError("RidSocketScheduler: socket path '%s' is too long", socketPath.c_str());
+    address.sun_family = AF_UNIX;
+    strcpy(address.sun_path, socketPath.c_str());
+
+    // a stale socket file from a crashed server would make bind() fail
+    unlink(socketPath.c_str());
+    listenerFd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listenerFd < 0)
+        throw cRuntimeError("RidSocketScheduler: cannot create socket: %s", strerror(errno));
+    if (bind(listenerFd, (sockaddr *)&address, sizeof(address)) < 0)
+        throw cRuntimeError("RidSocketScheduler: cannot bind to '%s': %s", socketPath.c_str(), strerror(errno));
+    if (listen(listenerFd, SOMAXCONN) < 0)
+        throw cRuntimeError("RidSocketScheduler: cannot listen on '%s': %s", socketPath.c_str(), strerror(errno));
+}
+
+void RidSocketScheduler::closeConnection()
+{
+    if (connectionFd >= 0) {
+        close(connectionFd);
+        connectionFd = -1;
+    }
+    readBuffer.clear();
+}
+
+bool RidSocketScheduler::receiveRequest(std::string& request)
+{
+    while (true) {
+        size_t newline = readBuffer.find('\n');
+        if (newline != std::string::npos) {
+            request = readBuffer.substr(0, newline);
+            readBuffer.erase(0, newline + 1);
+            if (request.find_first_not_of(" \t\r") == std::string::npos)
+                continue;
+            return true;
+        }
+        if (connectionFd < 0) {
+            if (listenerFd < 0)
+                return false;
+            connectionFd = accept(listenerFd, nullptr, nullptr);
+            if (connectionFd < 0) {
+                if (errno == EINTR)
+                    continue;
+                throw cRuntimeError("RidSocketScheduler: accept() failed: %s", strerror(errno));
+            }
+        }
+        char buffer[4096];
+        ssize_t n = read(connectionFd, buffer, sizeof(buffer));
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0) {
+            // client went away, a final request without newline still counts
+            std::string rest = readBuffer;
+            closeConnection();
+            if (rest.find_first_not_of(" \t\r") != std::string::npos) {
+                request = rest;
+                return true;
+            }
+            continue;
+        }
+        readBuffer.append(buffer, n);
+    }
+}
+
+void RidSocketScheduler::sendReply(const std::string& reply)
+{
+    if (connectionFd < 0)
+        return;
+    std::string line = reply + "\n";
+    size_t sent = 0;
+    while (sent < line.size()) {
+        // without MSG_NOSIGNAL a client gone before its reply would kill the daemon with SIGPIPE
+        ssize_t n = send(connectionFd, line.data() + sent, line.size() - sent, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0) {
+            if (n < 0 && errno != EPIPE && errno != ECONNRESET)
+                EV_WARN << "Cannot send the reply: " << strerror(errno) << endl;
+            else
+                EV_WARN << "Client disconnected before the reply was sent" << endl;
+            closeConnection();
+            return;
+        }
+        sent += n;
+    }
+}
+
+cEvent *RidSocketScheduler::guessNextEvent()
+{
+    return sim->getFES()->peekFirst();
+}
+
+cEvent *RidSocketScheduler::takeNextEvent()
+{
+    // the model only sits idle between requests, so wait for the next one
+    if (sim->getFES()->isEmpty()) {
+        if (serverModule == nullptr)
+            throw cTerminationException(E_ENDEDOK);
+        std::string json;
+        if (!receiveRequest(json))
+            throw cTerminationException(E_ENDEDOK);
+        auto request = new RidOneOffRequest("oneOffRequest");
+        request->setJson(json.c_str());
+        request->setArrival(serverModule->getId(), -1, sim->getSimTime());
+        sim->getFES()->insert(request);
+    }
+    return sim->getFES()->removeFirst();
+}
+
+void RidSocketScheduler::putBackEvent(cEvent *event)
+{
+    sim->getFES()->putBackFirst(event);
+}
@@ -0,0 +1,55 @@
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+//
+// Based on samples/sockets/cSocketRTScheduler.h from OMNeT++
+//
+
+#ifndef __RID_SOCKET_SCHEDULER_H
+#define __RID_SOCKET_SCHEDULER_H
+
+#include <omnetpp.h>
+
+using namespace omnetpp;
+
+//
+// Sequential scheduler that runs the model as fast as possible while there
+// are events, and blocks on a Unix domain socket for the next request once
+// the future event set runs empty. Requests are newline-delimited and are
+// delivered as RidOneOffRequest messages to the registered server module.
+//
+class RidSocketScheduler : public cScheduler
+{
+  protected:
+    cModule *serverModule = nullptr;
+    std::string socketPath;
+    int listenerFd = -1;
+    int connectionFd = -1;
+    std::string readBuffer;
+
+    virtual void setupListener();
+    virtual void closeConnection();
+
+    /** Blocks until a complete request line arrives, returns false if the listener is gone */
+    virtual bool receiveRequest(std::string& request);
+
+  public:
+    virtual ~RidSocketScheduler();
+
+    virtual std::string str() const override;
+
+    /** Called by the server module during initialization */
+    void setServerModule(cModule *module, const char *socketPath);
+
+    virtual cEvent *guessNextEvent() override;
+    virtual cEvent *takeNextEvent() override;
+    virtual void putBackEvent(cEvent *event) override;
+
+    /** Writes one reply line to the client of the request being served */
+    void sendReply(const std::string& reply);
+
+  protected:
+    virtual void startRun() override;
+    virtual void endRun() override;
+};
+
+#endif
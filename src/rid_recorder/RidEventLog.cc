@@ -0,0 +1,225 @@
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+//
+
+#include "RidEventLog.h"
+
+#include "inet/common/ModuleAccess.h"
+#include "inet/physicallayer/wireless/common/contract/packetlevel/SignalTag_m.h"
+
+#include "detectors/rssi_mlat/RssiMlatGcs.h"
+#include "detectors/rssi_mlat/RssiMlatMgmt.h"
+#include "detectors/rssi_mlat/RssiMlatReport_m.h"
+#include "rid_beacon/RidBeaconFrame_m.h"
+#include "rid_beacon/RidBeaconMgmt.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+using namespace inet::physicallayer;
+
+Define_Module(RidEventLog);
+
+static const char *kindNames[] = {"sent", "decoded", "report", "fix"};
+
+RidEventLog::~RidEventLog()
+{
+    if (file != nullptr)
+        fclose(file);
+}
+
+void RidEventLog::accountMemory(RidMemoryUsage& usage) const
+{
+    usage.recorderBufferBytes += index.capacity() * sizeof(RidEventLogIndexEntry);
+    usage.recorderBufferBytes += transmissions.size() * sizeof(transmissions.front());
+    usage.recorderBufferBytes += transmissionByTree.size() * (RidMemoryUsage::nodeOverhead + sizeof(std::pair<long, int64_t>));
+    usage.recorderBufferBytes += transmissionByBeacon.size() * (RidMemoryUsage::nodeOverhead + sizeof(std::pair<std::pair<int32_t, int64_t>, int64_t>));
+    usage.recorderBufferBytes += lastDecodeByHost.size() * (RidMemoryUsage::nodeOverhead + sizeof(std::pair<int, std::pair<int64_t, int64_t>>));
+}
+
+void RidEventLog::initialize(int stage)
+{
+    if (stage == INITSTAGE_LOCAL) {
+        eventLogFile = par("eventLogFile").stdstringValue();
+        int interval = par("indexInterval");
+        if (interval <= 0)
+            throw cRuntimeError("indexInterval must be positive");
+        indexInterval = interval;
+        linkHorizon = par("linkHorizon");
+        size_t dot = eventLogFile.find_last_of('.');
+        size_t slash = eventLogFile.find_last_of('/');
+        indexFile = (dot != std::string::npos && (slash == std::string::npos || dot > slash) ? eventLogFile.substr(0, dot) : eventLogFile) + ".ridevx";
+
+        cStringTokenizer tokenizer(par("kinds").stringValue());
+        while (tokenizer.hasMoreTokens()) {
+            std::string kind = tokenizer.nextToken();
+            auto it = std::find(std::begin(kindNames), std::end(kindNames), kind);
+            if (it == std::end(kindNames))
+                throw cRuntimeError("Unknown event kind '%s', expected sent, decoded, report or fix", kind.c_str());
+            recordKind[it - std::begin(kindNames)] = true;
+        }
+
+        file = fopen(eventLogFile.c_str(), "wb");
+        if (file == nullptr)
+            throw cRuntimeError("Cannot open '%s'", eventLogFile.c_str());
+        RidEventLogFileHeader header = {};
+        memcpy(header.magic, "RIDEV1\0", 8);
+        header.recordSize = sizeof(RidEventRecord);
+        header.indexInterval = indexInterval;
+        fwrite(&header, sizeof(header), 1, file);
+
+        // the RID-level story only, which is all that most inspections need
+        cModule *network = getSystemModule();
+        network->subscribe(RidBeaconMgmt::beaconSentSignal, this);
+        network->subscribe(RidBeaconMgmt::beaconReceivedSignal, this);
+        network->subscribe(RssiMlatMgmt::reportSentSignal, this);
+        network->subscribe(RssiMlatGcs::fixComputedSignal, this);
+
+        WATCH(numRecords);
+    }
+}
+
+void RidEventLog::finish()
+{
+    close();
+    for (int kind = 0; kind < 4; kind++)
+        if (recordKind[kind])
+            recordScalar((std::string("event log ") + kindNames[kind] + " records").c_str(), numKindRecords[kind]);
+}
+
+void RidEventLog::receiveSignal(cComponent *source, simsignal_t signalID, cObject *obj, cObject *details)
+{
+    if (file == nullptr)
+        return;
+    expireTransmissions();
+
+    RidEventRecord record = {};
+    record.eventNumber = getSimulation()->getEventNumber();
+    record.cause = -1;
+    record.time = simTime().dbl();
+    record.rssi = NAN;
+
+    if (signalID == RssiMlatGcs::fixComputedSignal) {
+        auto fix = check_and_cast<RssiMlatGcs::Fix *>(obj);
+        record.kind = RIDEV_FIX;
+        record.serialNumber = fix->senderSerialNumber;
+        record.host = -1;
+        record.count = fix->numReports;
+        // the reports of a fix share the serial number and timestamp of its beacon
+        record.cause = findTransmission(fix->senderSerialNumber, fix->timestamp);
+        record.timestamp = fix->timestamp;
+        record.x = fix->x;
+        record.y = fix->y;
+        record.z = fix->z;
+        append(record);
+        return;
+    }
+
+    if (signalID == RssiMlatMgmt::reportSentSignal) {
+        auto report = check_and_cast<RssiMlatReport *>(obj);
+        record.kind = RIDEV_REPORT;
+        record.serialNumber = report->getSenderSerialNumber();
+        record.host = report->getReceiverHostId();
+        record.timestamp = report->getTimestamp();
+        record.rssi = report->getRssi();
+        record.x = report->getTxPosX();
+        record.y = report->getTxPosY();
+        record.z = report->getTxPosZ();
+        // a report is made in the same event as the decode it is about
+        auto it = lastDecodeByHost.find(record.host);
+        if (it != lastDecodeByHost.end() && it->second.first == record.eventNumber)
+            record.cause = it->second.second;
+        append(record);
+        return;
+    }
+
+    auto packet = check_and_cast<Packet *>(obj);
+    auto beaconBody = packet->peekAtFront<RidBeaconFrame>();
+    cModule *host = getContainingNode(check_and_cast<cModule *>(source));
+    record.serialNumber = beaconBody->getSerialNumber();
+    record.host = host->getIndex();
+    record.timestamp = beaconBody->getTimestamp();
+    record.x = beaconBody->getPosX();
+    record.y = beaconBody->getPosY();
+    record.z = beaconBody->getPosZ();
+
+    if (signalID == RidBeaconMgmt::beaconSentSignal) {
+        record.kind = RIDEV_BEACON_SENT;
+        int64_t position = append(record);
+        if (position >= 0) {
+            // received copies of the packet keep its tree id
+            Transmission transmission{position, packet->getTreeId(), {record.serialNumber, record.timestamp}};
+            transmissions.push_back({simTime(), transmission});
+            transmissionByTree[transmission.treeId] = position;
+            transmissionByBeacon[transmission.beacon] = position;
+        }
+    }
+    else if (signalID == RidBeaconMgmt::beaconReceivedSignal) {
+        record.kind = RIDEV_BEACON_DECODED;
+        auto signalPowerInd = packet->findTag<SignalPowerInd>();
+        if (signalPowerInd != nullptr)
+            record.rssi = 10 * std::log10(signalPowerInd->getPower().get() * 1000);
+        auto it = transmissionByTree.find(packet->getTreeId());
+        if (it != transmissionByTree.end())
+            record.cause = it->second;
+        int64_t position = append(record);
+        if (position >= 0)
+            lastDecodeByHost[record.host] = {record.eventNumber, position};
+    }
+}
+
+int64_t RidEventLog::append(RidEventRecord& record)
+{
+    if (!recordKind[record.kind])
+        return -1;
+    if (numRecords % indexInterval == 0)
+        index.push_back({record.time, numRecords});
+    if (fwrite(&record, sizeof(record), 1, file) != 1)
+        throw cRuntimeError("Cannot write '%s'", eventLogFile.c_str());
+    numKindRecords[record.kind]++;
+    return numRecords++;
+}
+
+void RidEventLog::expireTransmissions()
+{
+    simtime_t horizon = simTime() - linkHorizon;
+    while (!transmissions.empty() && transmissions.front().first < horizon) {
+        const Transmission& transmission = transmissions.front().second;
+        // a later transmission may have taken over the key
+        auto byTree = transmissionByTree.find(transmission.treeId);
+        if (byTree != transmissionByTree.end() && byTree->second == transmission.record)
+            transmissionByTree.erase(byTree);
+        auto byBeacon = transmissionByBeacon.find(transmission.beacon);
+        if (byBeacon != transmissionByBeacon.end() && byBeacon->second == transmission.record)
+            transmissionByBeacon.erase(byBeacon);
+        transmissions.pop_front();
+    }
+}
+
+int64_t RidEventLog::findTransmission(int32_t serialNumber, int64_t timestamp) const
+{
+    auto it = transmissionByBeacon.find({serialNumber, timestamp});
+    return it != transmissionByBeacon.end() ? it->second : -1;
+}
+
+void RidEventLog::close()
+{
+    if (file == nullptr)
+        return;
+    if (fclose(file) != 0)
+        throw cRuntimeError("Cannot write '%s'", eventLogFile.c_str());
+    file = nullptr;
+
+    FILE *f = fopen(indexFile.c_str(), "wb");
+    if (f == nullptr)
+        throw cRuntimeError("Cannot open '%s'", indexFile.c_str());
+    RidEventLogIndexHeader header = {};
+    memcpy(header.magic, "RIDEVX1", 8);
+    header.numEntries = index.size();
+    fwrite(&header, sizeof(header), 1, f);
+    fwrite(index.data(), sizeof(RidEventLogIndexEntry), index.size(), f);
+    if (fclose(f) != 0)
+        throw cRuntimeError("Cannot write '%s'", indexFile.c_str());
+    index.clear();
+}
@@ -0,0 +1,73 @@
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+//
+
+#ifndef __RID_EVENT_LOG_H
+#define __RID_EVENT_LOG_H
+
+#include "inet/common/INETDefs.h"
+
+#include "RidEventLogRecord.h"
+#include "RidMemoryAccounting.h"
+
+#include <cstdio>
+#include <deque>
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+using namespace inet;
+
+class RidEventLog : public cSimpleModule, protected cListener, public IRidMemoryAccounting
+{
+  protected:
+    std::string eventLogFile;
+    std::string indexFile;
+    uint32_t indexInterval;
+    simtime_t linkHorizon;
+    bool recordKind[4] = {};
+
+    FILE *file = nullptr;
+    uint64_t numRecords = 0;
+    std::vector<RidEventLogIndexEntry> index;
+    uint64_t numKindRecords[4] = {};
+
+    // Records that later ones may link to, forgotten after linkHorizon
+    struct Transmission {
+        int64_t record;
+        long treeId;
+        std::pair<int32_t, int64_t> beacon;  // serial number and timestamp
+    };
+    std::deque<std::pair<simtime_t, Transmission>> transmissions;
+    std::unordered_map<long, int64_t> transmissionByTree;
+    std::map<std::pair<int32_t, int64_t>, int64_t> transmissionByBeacon;
+    // last decode of each host, with its event number, the cause of the report made in the same event
+    std::map<int, std::pair<int64_t, int64_t>> lastDecodeByHost;
+
+  public:
+    virtual ~RidEventLog();
+
+    virtual void accountMemory(RidMemoryUsage& usage) const override;
+
+  protected:
+    virtual int numInitStages() const override { return NUM_INIT_STAGES; }
+    virtual void initialize(int stage) override;
+    virtual void handleMessage(cMessage *msg) override { throw cRuntimeError("This module does not handle messages"); }
+    virtual void finish() override;
+
+    virtual void receiveSignal(cComponent *source, simsignal_t signalID, cObject *obj, cObject *details) override;
+
+    /** Utility function: writes a record and returns its position in the file, -1 if its kind is not recorded */
+    virtual int64_t append(RidEventRecord& record);
+
+    /** Utility function: forgets transmissions older than linkHorizon */
+    void expireTransmissions();
+
+    /** Utility function: returns the transmission record of a beacon, -1 if unknown or forgotten */
+    int64_t findTransmission(int32_t serialNumber, int64_t timestamp) const;
+
+    /** Utility function: writes the index and closes the log */
+    virtual void close();
+};
+
+#endif
@@ -0,0 +1,57 @@
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+//
+
+#ifndef __RID_EVENT_LOG_RECORD_H
+#define __RID_EVENT_LOG_RECORD_H
+
+#include <cstdint>
+
+//
+// On-disk layout of RidEventLog files, all little endian. Readers are in
+// container/rid_event_log.py; keep both in sync.
+//
+// .ridev:  RidEventLogFileHeader, then RidEventRecords in simulation time
+//          order; a record is referred to by its position in the file
+// .ridevx: RidEventLogIndexHeader, then a RidEventLogIndexEntry for every
+//          indexInterval-th record
+//
+
+enum RidEventKind : int32_t {
+    RIDEV_BEACON_SENT = 0,
+    RIDEV_BEACON_DECODED = 1,
+    RIDEV_REPORT = 2,
+    RIDEV_FIX = 3,
+};
+
+struct RidEventRecord {
+    int32_t kind;               // RidEventKind
+    int32_t serialNumber;       // claimed in the beacon
+    int32_t host;               // sending, decoding or reporting host, -1 for fixes
+    int32_t count;              // reports behind a fix, 0 otherwise
+    int64_t eventNumber;        // of the OMNeT++ event, to look it up in a full eventlog
+    int64_t cause;              // record that caused this one, -1 if none is known
+    int64_t timestamp;          // Remote ID timestamp
+    double time;                // simulation time
+    double rssi;                // dBm for decoded beacons and reports, NaN otherwise
+    double x, y, z;             // position claimed in the beacon, the estimate for fixes
+};
+static_assert(sizeof(RidEventRecord) == 80, "RidEventRecord layout changed");
+
+struct RidEventLogFileHeader {
+    char magic[8];              // "RIDEV1\0\0"
+    uint32_t recordSize;
+    uint32_t indexInterval;
+};
+
+struct RidEventLogIndexHeader {
+    char magic[8];              // "RIDEVX1\0"
+    uint64_t numEntries;
+};
+
+struct RidEventLogIndexEntry {
+    double time;
+    uint64_t record;
+};
+
+#endif
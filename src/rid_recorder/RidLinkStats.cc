@@ -0,0 +1,101 @@
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+//
+
+#include "RidLinkStats.h"
+
+#include "inet/common/ModuleAccess.h"
+#include "inet/physicallayer/wireless/common/contract/packetlevel/SignalTag_m.h"
+
+#include "rid_beacon/RidBeaconFrame_m.h"
+#include "rid_beacon/RidBeaconMgmt.h"
+
+#include <cmath>
+#include <fstream>
+
+using namespace inet::physicallayer;
+
+Define_Module(RidLinkStats);
+
+void RidLinkStats::initialize(int stage)
+{
+    if (stage == INITSTAGE_LOCAL) {
+        statsFile = par("statsFile").stdstringValue();
+        rssiMin = par("rssiMin");
+        rssiMax = par("rssiMax");
+        rssiBins = par("rssiBins");
+        gapMin = par("gapMin");
+        gapMax = par("gapMax");
+        gapBins = par("gapBins");
+        if (rssiBins <= 0 || gapBins <= 0)
+            throw cRuntimeError("histograms need at least one bin");
+        if (rssiMax <= rssiMin || gapMax <= gapMin)
+            throw cRuntimeError("histogram ranges must not be empty");
+
+        getSystemModule()->subscribe(RidBeaconMgmt::beaconReceivedSignal, this);
+    }
+}
+
+void RidLinkStats::accountMemory(RidMemoryUsage& usage) const
+{
+    size_t histogramBytes = (rssiBins + 2 + gapBins + 2) * sizeof(uint64_t);
+    usage.recorderBufferBytes += links.size() * (RidMemoryUsage::nodeOverhead + sizeof(std::pair<const std::pair<int, int>, Link>) + histogramBytes);
+}
+
+void RidLinkStats::receiveSignal(cComponent *source, simsignal_t signalID, cObject *obj, cObject *details)
+{
+    auto packet = check_and_cast<Packet *>(obj);
+    int serialNumber = packet->peekAtFront<RidBeaconFrame>()->getSerialNumber();
+    int host = getContainingNode(check_and_cast<cModule *>(source))->getIndex();
+
+    auto it = links.find({serialNumber, host});
+    if (it == links.end())
+        it = links.emplace(std::make_pair(serialNumber, host), Link{{}, {rssiMin, rssiMax, rssiBins}, {}, {gapMin, gapMax, gapBins}}).first;
+    Link& link = it->second;
+
+    auto signalPowerInd = packet->findTag<SignalPowerInd>();
+    if (signalPowerInd != nullptr) {
+        double rssiDbm = 10 * std::log10(signalPowerInd->getPower().get() * 1000);
+        link.rssi.add(rssiDbm);
+        link.rssiHistogram.add(rssiDbm);
+    }
+
+    auto signalTimeInd = packet->findTag<SignalTimeInd>();
+    double time = signalTimeInd != nullptr ? signalTimeInd->getStartTime().dbl() : simTime().dbl();
+    if (!std::isnan(link.lastTime)) {
+        link.gap.add(time - link.lastTime);
+        link.gapHistogram.add(time - link.lastTime);
+    }
+    link.lastTime = time;
+}
+
+void RidLinkStats::finish()
+{
+    std::ofstream out(statsFile);
+    if (!out)
+        throw cRuntimeError("Cannot open '%s'", statsFile.c_str());
+    out.precision(17);
+
+    auto writeStats = [&](const utils::RunningStats& stats, const utils::FixedHistogram& histogram) {
+        out << ',' << stats.getCount() << ',' << stats.getMean() << ',' << stats.getStddev() << ',' << stats.getMin() << ',' << stats.getMax() << ',';
+        const char *separator = "";
+        for (uint64_t count : histogram.getCounts()) {
+            out << separator << count;
+            separator = " ";
+        }
+    };
+
+    out << "serial_number,host"
+        << ",rssi_count,rssi_mean,rssi_stddev,rssi_min,rssi_max,rssi_histogram"
+        << ",gap_count,gap_mean,gap_stddev,gap_min,gap_max,gap_histogram\n";
+    for (const auto& [key, link] : links) {
+        out << key.first << ',' << key.second;
+        writeStats(link.rssi, link.rssiHistogram);
+        writeStats(link.gap, link.gapHistogram);
+        out << '\n';
+    }
+    if (!out)
+        throw cRuntimeError("Cannot write '%s'", statsFile.c_str());
+
+    recordScalar("links", links.size());
+}
@@ -0,0 +1,50 @@
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+//
+
+#ifndef __RID_LINK_STATS_H
+#define __RID_LINK_STATS_H
+
+#include "inet/common/INETDefs.h"
+
+#include "utils/running_stats.h"
+
+#include "RidMemoryAccounting.h"
+
+#include <map>
+
+using namespace inet;
+
+class RidLinkStats : public cSimpleModule, protected cListener, public IRidMemoryAccounting
+{
+  protected:
+    struct Link {
+        utils::RunningStats rssi;
+        utils::FixedHistogram rssiHistogram;
+        utils::RunningStats gap;
+        utils::FixedHistogram gapHistogram;
+        double lastTime = NAN;
+    };
+
+    std::string statsFile;
+    double rssiMin, rssiMax;
+    int rssiBins;
+    double gapMin, gapMax;
+    int gapBins;
+
+    // keyed by (transmitter serial number, receiving host index)
+    std::map<std::pair<int, int>, Link> links;
+
+  public:
+    virtual void accountMemory(RidMemoryUsage& usage) const override;
+
+  protected:
+    virtual int numInitStages() const override { return NUM_INIT_STAGES; }
+    virtual void initialize(int stage) override;
+    virtual void handleMessage(cMessage *msg) override { throw cRuntimeError("This module does not handle messages"); }
+    virtual void finish() override;
+
+    virtual void receiveSignal(cComponent *source, simsignal_t signalID, cObject *obj, cObject *details) override;
+};
+
+#endif
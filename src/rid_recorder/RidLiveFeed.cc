@@ -0,0 +1,76 @@
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+//
+
+#include "RidLiveFeed.h"
+
+#include <omnetpp.h>
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+using namespace omnetpp;
+
+std::map<std::string, std::weak_ptr<RidLiveFeed>> RidLiveFeed::feeds;
+
+RidLiveFeed::RidLiveFeed(const std::string& name, uint32_t capacity) : name(name)
+{
+    if (capacity == 0)
+        throw cRuntimeError("Live feed capacity must be positive");
+    // start from a fresh segment, readers of a previous run keep their old mapping
+    shm_unlink(name.c_str());
+    fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (fd < 0)
+        throw cRuntimeError("Cannot create shared memory '%s': %s", name.c_str(), strerror(errno));
+    size = sizeof(RidLiveHeader) + (size_t)capacity * sizeof(RidLiveRecord);
+    if (ftruncate(fd, size) < 0)
+        throw cRuntimeError("Cannot size shared memory '%s': %s", name.c_str(), strerror(errno));
+    void *p = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (p == MAP_FAILED)
+        throw cRuntimeError("Cannot map shared memory '%s': %s", name.c_str(), strerror(errno));
+    // ftruncate zero-fills, so every slot starts out with seq 0, i.e. empty
+    header = static_cast<RidLiveHeader *>(p);
+    records = reinterpret_cast<RidLiveRecord *>(header + 1);
+    header->recordSize = sizeof(RidLiveRecord);
+    header->capacity = capacity;
+    header->next.store(0, std::memory_order_relaxed);
+    // the magic goes last, readers wait for it
+    std::atomic_thread_fence(std::memory_order_release);
+    memcpy(header->magic, "RIDLIVE1", 8);
+}
+
+RidLiveFeed::~RidLiveFeed()
+{
+    // the segment stays until the next run so late readers can still drain it
+    if (header != nullptr)
+        munmap(header, size);
+    if (fd >= 0)
+        close(fd);
+}
+
+std::shared_ptr<RidLiveFeed> RidLiveFeed::get(const std::string& name, uint32_t capacity)
+{
+    auto feed = feeds[name].lock();
+    if (feed == nullptr) {
+        feed = std::make_shared<RidLiveFeed>(name, capacity);
+        feeds[name] = feed;
+    }
+    else if (feed->header->capacity != capacity)
+        throw cRuntimeError("Live feed '%s' already exists with capacity %u", name.c_str(), feed->header->capacity);
+    return feed;
+}
+
+void RidLiveFeed::publish(const RidLiveRecord& record)
+{
+    uint64_t n = header->next.load(std::memory_order_relaxed);
+    RidLiveRecord& slot = records[n % header->capacity];
+    slot.seq.store(2 * n + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    // everything but seq
+    memcpy(reinterpret_cast<char *>(&slot) + sizeof(slot.seq), reinterpret_cast<const char *>(&record) + sizeof(record.seq), sizeof(record) - sizeof(record.seq));
+    slot.seq.store(2 * n + 2, std::memory_order_release);
+    header->next.store(n + 1, std::memory_order_release);
+}
@@ -0,0 +1,78 @@
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+//
+
+#ifndef __RID_LIVE_FEED_H
+#define __RID_LIVE_FEED_H
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+
+//
+// Shared memory ring under /dev/shm that external processes tail while the
+// simulation runs (container/rid-live-tail.py). There is one writer, the
+// simulation thread, and any number of readers that the writer never waits
+// for. Readers that fall a full ring behind see overwritten slots and skip
+// ahead.
+//
+// Layout, all little endian: RidLiveHeader, then capacity RidLiveRecord
+// slots. Record n goes to slot n % capacity. Its seq is 2n + 1 while it is
+// being written and 2n + 2 once complete (a seqlock), so a reader copies
+// the slot and accepts it if seq was 2n + 2 both before and after.
+//
+enum RidLiveKind : int32_t {
+    RIDLIVE_TRANSMISSION = 0,
+    RIDLIVE_RECEPTION = 1,
+    RIDLIVE_FIX = 2,
+};
+
+struct RidLiveRecord {
+    std::atomic<uint64_t> seq;
+    int32_t kind;               // RidLiveKind
+    int32_t serialNumber;       // claimed in the beacon
+    int32_t host;               // transmitting or receiving host index, -1 for fixes
+    int32_t count;              // number of reports of a fix
+    int64_t timestamp;          // Remote ID timestamp
+    double time;
+    double rssi;                // dBm of a reception, NaN otherwise
+    double x, y, z;             // position claimed in the beacon
+    double u, v, w;             // receiver position of a reception, estimated position of a fix
+};
+static_assert(sizeof(RidLiveRecord) == 96, "RidLiveRecord layout changed");
+
+struct RidLiveHeader {
+    char magic[8];              // "RIDLIVE1"
+    uint32_t recordSize;
+    uint32_t capacity;
+    std::atomic<uint64_t> next; // number of records published so far
+    char reserved[40];
+};
+static_assert(sizeof(RidLiveHeader) == 64, "RidLiveHeader layout changed");
+
+class RidLiveFeed
+{
+  protected:
+    std::string name;
+    int fd = -1;
+    size_t size = 0;
+    RidLiveHeader *header = nullptr;
+    RidLiveRecord *records = nullptr;
+
+    // feeds shared by all modules publishing under the same name
+    static std::map<std::string, std::weak_ptr<RidLiveFeed>> feeds;
+
+  public:
+    RidLiveFeed(const std::string& name, uint32_t capacity);
+    ~RidLiveFeed();
+
+    /** Returns the feed with the given shm name, creating it for the first user */
+    static std::shared_ptr<RidLiveFeed> get(const std::string& name, uint32_t capacity);
+
+    /** Copies the record into the next slot, seq is filled in */
+    void publish(const RidLiveRecord& record);
+};
+
+#endif
@@ -0,0 +1,62 @@
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+//
+
+#ifndef __RID_LOG_RECORD_H
+#define __RID_LOG_RECORD_H
+
+#include <cstdint>
+
+//
+// On-disk layout of RidLogRecorder files, all little endian. Readers are in
+// container/rid_log.py; keep both in sync.
+//
+// .ridlog: RidLogFileHeader, then blocks of up to blockRecords records that
+//          all have the same serial number
+// .ridx:   RidLogIndexHeader, then for each serial number a RidLogIndexSerial
+//          followed by its RidLogIndexBlock entries in file order
+//
+
+enum RidLogKind : int32_t {
+    RIDLOG_TRANSMISSION = 0,
+    RIDLOG_RECEPTION = 1,
+};
+
+struct RidLogRecord {
+    int32_t kind;               // RidLogKind
+    int32_t serialNumber;       // claimed in the beacon
+    int32_t host;               // index of the transmitting or receiving host
+    int32_t reserved;
+    int64_t timestamp;          // Remote ID timestamp
+    double time;                // transmission time, or reception start
+    double rssi;                // dBm, NaN for transmissions
+    double x, y, z;             // position claimed in the beacon
+    double rxX, rxY, rxZ;       // receiver position, NaN for transmissions
+};
+static_assert(sizeof(RidLogRecord) == 88, "RidLogRecord layout changed");
+
+struct RidLogFileHeader {
+    char magic[8];              // "RIDLOG1\0"
+    uint32_t recordSize;
+    uint32_t blockRecords;
+};
+
+struct RidLogIndexHeader {
+    char magic[8];              // "RIDX1\0\0\0"
+    uint32_t numSerials;
+    uint32_t reserved;
+};
+
+struct RidLogIndexSerial {
+    int32_t serialNumber;
+    uint32_t numBlocks;
+};
+
+struct RidLogIndexBlock {
+    uint64_t offset;            // of the first record in the .ridlog
+    uint32_t count;
+    uint32_t reserved;
+    double minTime, maxTime;
+};
+
+#endif
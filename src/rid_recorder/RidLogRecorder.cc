@@ -0,0 +1,250 @@
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+//
+
+#include "RidLogRecorder.h"
+
+#include "inet/common/ModuleAccess.h"
+#include "inet/mobility/contract/IMobility.h"
+#include "inet/physicallayer/wireless/common/contract/packetlevel/SignalTag_m.h"
+
+#include "rid_beacon/RidBeaconFrame_m.h"
+#include "rid_beacon/RidBeaconMgmt.h"
+
+#include <cmath>
+#include <cstring>
+
+using namespace inet::physicallayer;
+
+Define_Module(RidLogRecorder);
+
+RidLogRecorder::~RidLogRecorder()
+{
+    try {
+        stopWriter();
+    }
+    catch (...) {
+    }
+    if (file != nullptr)
+        fclose(file);
+}
+
+void RidLogRecorder::accountMemory(RidMemoryUsage& usage) const
+{
+    if (ring) {
+        // the blocks belong to the writer thread, only the ring is safe to look at
+        usage.recorderBufferBytes += ring->capacity() * sizeof(RidLogRecord);
+        return;
+    }
+    for (const auto& entry : pending)
+        usage.recorderBufferBytes += RidMemoryUsage::nodeOverhead + sizeof(entry) + entry.second.capacity() * sizeof(RidLogRecord);
+    for (const auto& entry : index)
+        usage.recorderBufferBytes += RidMemoryUsage::nodeOverhead + sizeof(entry) + entry.second.capacity() * sizeof(RidLogIndexBlock);
+}
+
+void RidLogRecorder::initialize(int stage)
+{
+    if (stage == INITSTAGE_LOCAL) {
+        logFile = par("logFile").stdstringValue();
+        blockRecords = par("blockRecords");
+        if (blockRecords == 0)
+            throw cRuntimeError("blockRecords must be positive");
+        size_t dot = logFile.find_last_of('.');
+        size_t slash = logFile.find_last_of('/');
+        indexFile = (dot != std::string::npos && (slash == std::string::npos || dot > slash) ? logFile.substr(0, dot) : logFile) + ".ridx";
+
+        file = fopen(logFile.c_str(), "wb");
+        if (file == nullptr)
+            throw cRuntimeError("Cannot open '%s'", logFile.c_str());
+        RidLogFileHeader header = {};
+        memcpy(header.magic, "RIDLOG1", 8);
+        header.recordSize = sizeof(RidLogRecord);
+        header.blockRecords = blockRecords;
+        fwrite(&header, sizeof(header), 1, file);
+        offset = sizeof(header);
+
+        if (par("asyncWriter")) {
+            int ringCapacity = par("ringCapacity");
+            if (ringCapacity <= 0)
+                throw cRuntimeError("ringCapacity must be positive");
+            ring = std::make_unique<utils::SpscRing<RidLogRecord>>(ringCapacity);
+            writer = std::thread(&RidLogRecorder::runWriter, this);
+        }
+
+        cModule *network = getSystemModule();
+        network->subscribe(RidBeaconMgmt::beaconSentSignal, this);
+        network->subscribe(RidBeaconMgmt::beaconReceivedSignal, this);
+    }
+}
+
+void RidLogRecorder::finish()
+{
+    close();
+    if (ring)
+        recordScalar("writer stalls", numStalls);
+}
+
+void RidLogRecorder::receiveSignal(cComponent *source, simsignal_t signalID, cObject *obj, cObject *details)
+{
+    if (file == nullptr)
+        return;
+
+    auto packet = check_and_cast<Packet *>(obj);
+    auto beaconBody = packet->peekAtFront<RidBeaconFrame>();
+    cModule *host = getContainingNode(check_and_cast<cModule *>(source));
+
+    RidLogRecord record = {};
+    record.serialNumber = beaconBody->getSerialNumber();
+    record.host = host->getIndex();
+    record.timestamp = beaconBody->getTimestamp();
+    record.x = beaconBody->getPosX();
+    record.y = beaconBody->getPosY();
+    record.z = beaconBody->getPosZ();
+
+    if (signalID == RidBeaconMgmt::beaconSentSignal) {
+        record.kind = RIDLOG_TRANSMISSION;
+        record.time = simTime().dbl();
+        record.rssi = record.rxX = record.rxY = record.rxZ = NAN;
+    }
+    else if (signalID == RidBeaconMgmt::beaconReceivedSignal) {
+        auto mobility = check_and_cast<IMobility *>(host->getSubmodule("mobility"));
+        Coord position = mobility->getCurrentPosition();
+        auto signalPowerInd = packet->findTag<SignalPowerInd>();
+        auto signalTimeInd = packet->findTag<SignalTimeInd>();
+        record.kind = RIDLOG_RECEPTION;
+        record.time = signalTimeInd != nullptr ? signalTimeInd->getStartTime().dbl() : simTime().dbl();
+        record.rssi = signalPowerInd != nullptr ? 10 * std::log10(signalPowerInd->getPower().get() * 1000) : NAN;
+        record.rxX = position.x;
+        record.rxY = position.y;
+        record.rxZ = position.z;
+    }
+    else
+        return;
+    append(record);
+}
+
+void RidLogRecorder::append(const RidLogRecord& record)
+{
+    if (!ring) {
+        consume(record);
+        return;
+    }
+    if (writerFailed)
+        throw cRuntimeError("%s", writerError.c_str());
+    // backpressure: wait for the writer instead of dropping records
+    if (!ring->tryPush(record)) {
+        numStalls++;
+        writerWakeup.notify_one();
+        while (!ring->tryPush(record)) {
+            if (writerFailed)
+                throw cRuntimeError("%s", writerError.c_str());
+            std::this_thread::yield();
+        }
+    }
+    if (writerIdle.load(std::memory_order_relaxed)) {
+        std::lock_guard<std::mutex> lock(writerMutex);
+        writerWakeup.notify_one();
+    }
+}
+
+void RidLogRecorder::runWriter()
+{
+    std::vector<RidLogRecord> batch(1024);
+    try {
+        while (true) {
+            size_t n = ring->tryPop(batch.data(), batch.size());
+            for (size_t i = 0; i < n; i++)
+                consume(batch[i]);
+            if (n > 0)
+                continue;
+            if (stopping) {
+                // the producer is done, whatever it pushed is visible by now
+                if (ring->tryPop(batch.data(), 1) == 1) {
+                    consume(batch[0]);
+                    continue;
+                }
+                return;
+            }
+            std::unique_lock<std::mutex> lock(writerMutex);
+            writerIdle = true;
+            writerWakeup.wait_for(lock, std::chrono::milliseconds(10));
+            writerIdle = false;
+        }
+    }
+    catch (std::exception& e) {
+        writerError = e.what();
+        writerFailed = true;
+    }
+}
+
+void RidLogRecorder::stopWriter()
+{
+    if (!writer.joinable())
+        return;
+    {
+        std::lock_guard<std::mutex> lock(writerMutex);
+        stopping = true;
+    }
+    writerWakeup.notify_one();
+    writer.join();
+    if (writerFailed)
+        throw cRuntimeError("%s", writerError.c_str());
+}
+
+void RidLogRecorder::consume(const RidLogRecord& record)
+{
+    auto& block = pending[record.serialNumber];
+    if (block.capacity() < blockRecords)
+        block.reserve(blockRecords);
+    block.push_back(record);
+    if (block.size() >= blockRecords)
+        writeBlock(block);
+}
+
+void RidLogRecorder::writeBlock(std::vector<RidLogRecord>& records)
+{
+    if (records.empty())
+        return;
+    RidLogIndexBlock block = {};
+    block.offset = offset;
+    block.count = records.size();
+    block.minTime = block.maxTime = records[0].time;
+    for (auto& record : records) {
+        block.minTime = std::min(block.minTime, record.time);
+        block.maxTime = std::max(block.maxTime, record.time);
+    }
+    if (fwrite(records.data(), sizeof(RidLogRecord), records.size(), file) != records.size())
+        // may run on the writer thread, which must not construct cRuntimeError
+        throw std::runtime_error("Cannot write '" + logFile + "'");
+    offset += records.size() * sizeof(RidLogRecord);
+    index[records[0].serialNumber].push_back(block);
+    records.clear();
+}
+
+void RidLogRecorder::close()
+{
+    if (file == nullptr)
+        return;
+    stopWriter();
+    for (auto& [serialNumber, records] : pending)
+        writeBlock(records);
+    pending.clear();
+    fclose(file);
+    file = nullptr;
+
+    FILE *f = fopen(indexFile.c_str(), "wb");
+    if (f == nullptr)
+        throw cRuntimeError("Cannot open '%s'", indexFile.c_str());
+    RidLogIndexHeader header = {};
+    memcpy(header.magic, "RIDX1\0\0", 8);
+    header.numSerials = index.size();
+    fwrite(&header, sizeof(header), 1, f);
+    for (auto& [serialNumber, blocks] : index) {
+        RidLogIndexSerial serial = {serialNumber, (uint32_t)blocks.size()};
+        fwrite(&serial, sizeof(serial), 1, f);
+        fwrite(blocks.data(), sizeof(RidLogIndexBlock), blocks.size(), f);
+    }
+    if (fclose(f) != 0)
+        throw cRuntimeError("Cannot write '%s'", indexFile.c_str());
+    index.clear();
+}
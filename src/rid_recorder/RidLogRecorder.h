@@ -0,0 +1,82 @@
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+//
+
+#ifndef __RID_LOG_RECORDER_H
+#define __RID_LOG_RECORDER_H
+
+#include "inet/common/INETDefs.h"
+
+#include "utils/spsc_ring.h"
+
+#include "RidLogRecord.h"
+#include "RidMemoryAccounting.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdio>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace inet;
+
+class RidLogRecorder : public cSimpleModule, protected cListener, public IRidMemoryAccounting
+{
+  protected:
+    std::string logFile;
+    std::string indexFile;
+    size_t blockRecords;
+
+    FILE *file = nullptr;
+    uint64_t offset = 0;
+
+    // records of the block being filled, per serial number, owned by the writer
+    std::map<int32_t, std::vector<RidLogRecord>> pending;
+    std::map<int32_t, std::vector<RidLogIndexBlock>> index;
+
+    // background writer
+    std::unique_ptr<utils::SpscRing<RidLogRecord>> ring;
+    std::thread writer;
+    std::mutex writerMutex;
+    std::condition_variable writerWakeup;
+    std::atomic<bool> writerIdle{false};
+    std::atomic<bool> stopping{false};
+    std::atomic<bool> writerFailed{false};
+    std::string writerError;
+    uint64_t numStalls = 0;
+
+  public:
+    virtual ~RidLogRecorder();
+
+    virtual void accountMemory(RidMemoryUsage& usage) const override;
+
+  protected:
+    virtual int numInitStages() const override { return NUM_INIT_STAGES; }
+    virtual void initialize(int stage) override;
+    virtual void handleMessage(cMessage *msg) override { throw cRuntimeError("This module does not handle messages"); }
+    virtual void finish() override;
+
+    virtual void receiveSignal(cComponent *source, simsignal_t signalID, cObject *obj, cObject *details) override;
+
+    /** Utility function: hands a record to the writer */
+    virtual void append(const RidLogRecord& record);
+
+    /** Utility function: adds a record to the block of its serial number, runs on the writer */
+    virtual void consume(const RidLogRecord& record);
+
+    /** Body of the writer thread */
+    void runWriter();
+
+    /** Utility function: stops the writer thread after it has drained the ring */
+    void stopWriter();
+
+    /** Utility function: writes a block and indexes it */
+    virtual void writeBlock(std::vector<RidLogRecord>& records);
+
+    /** Utility function: writes the remaining blocks and the index */
+    virtual void close();
+};
+
+#endif
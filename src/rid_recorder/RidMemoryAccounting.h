@@ -0,0 +1,37 @@
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+//
+
+#ifndef __RID_MEMORY_ACCOUNTING_H
+#define __RID_MEMORY_ACCOUNTING_H
+
+#include <cstddef>
+
+/** Bytes and objects held by the Remote ID modules, summed up by RidMemoryMonitor */
+struct RidMemoryUsage
+{
+    // rough heap cost of one node of a std::map or std::unordered_map beyond its value
+    static constexpr size_t nodeOverhead = 32;
+
+    size_t gcsReportBytes = 0;      // report groups waiting at the GCS, including the reports
+    size_t gcsReports = 0;          // reports waiting at the GCS
+    size_t recorderBufferBytes = 0; // buffers of recorders and aggregators
+    size_t hostStateBytes = 0;      // per-host Remote ID state (sampling, fast-forward capture)
+};
+
+//
+// Implemented by modules that can tell how much memory they hold. The
+// estimates count the containers and the objects in them, not allocator
+// slack, so they are meant for trends and attribution rather than exact
+// totals.
+//
+class IRidMemoryAccounting
+{
+  public:
+    virtual ~IRidMemoryAccounting() {}
+
+    /** Adds the memory held by this module to usage */
+    virtual void accountMemory(RidMemoryUsage& usage) const = 0;
+};
+
+#endif
@@ -0,0 +1,99 @@
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+//
+
+#include "RidMemoryMonitor.h"
+
+#include "detectors/rssi_mlat/RssiMlatReport_m.h"
+
+#include <cstdio>
+#include <unistd.h>
+
+Define_Module(RidMemoryMonitor);
+
+simsignal_t RidMemoryMonitor::gcsReportBytesSignal = cComponent::registerSignal("gcsReportBytes");
+simsignal_t RidMemoryMonitor::gcsReportsSignal = cComponent::registerSignal("gcsReports");
+simsignal_t RidMemoryMonitor::reportsInFlightSignal = cComponent::registerSignal("reportsInFlight");
+simsignal_t RidMemoryMonitor::packetsInFlightSignal = cComponent::registerSignal("packetsInFlight");
+simsignal_t RidMemoryMonitor::packetBytesInFlightSignal = cComponent::registerSignal("packetBytesInFlight");
+simsignal_t RidMemoryMonitor::recorderBufferBytesSignal = cComponent::registerSignal("recorderBufferBytes");
+simsignal_t RidMemoryMonitor::hostStateBytesSignal = cComponent::registerSignal("hostStateBytes");
+simsignal_t RidMemoryMonitor::processRssSignal = cComponent::registerSignal("processRss");
+
+RidMemoryMonitor::~RidMemoryMonitor()
+{
+    cancelAndDelete(sampleTimer);
+}
+
+void RidMemoryMonitor::initialize()
+{
+    sampleInterval = par("sampleInterval");
+    if (sampleInterval <= SIMTIME_ZERO)
+        throw cRuntimeError("sampleInterval must be positive");
+    sampleTimer = new cMessage("sampleTimer");
+    scheduleAt(simTime(), sampleTimer);
+}
+
+void RidMemoryMonitor::handleMessage(cMessage *msg)
+{
+    if (msg != sampleTimer)
+        throw cRuntimeError("This module does not handle messages");
+    sample();
+    scheduleAfter(sampleInterval, sampleTimer);
+}
+
+void RidMemoryMonitor::finish()
+{
+    // the state at the end, which is where leaks show
+    sample();
+}
+
+void RidMemoryMonitor::sample()
+{
+    RidMemoryUsage usage;
+    collect(getSystemModule(), usage);
+
+    // reports and radio signals travel as scheduled messages
+    size_t reportsInFlight = 0;
+    size_t packetsInFlight = 0;
+    size_t packetBytesInFlight = 0;
+    cFutureEventSet *fes = getSimulation()->getFES();
+    for (int i = 0; i < fes->getLength(); i++) {
+        cEvent *event = fes->get(i);
+        if (dynamic_cast<RssiMlatReport *>(event) != nullptr)
+            reportsInFlight++;
+        else if (auto packet = dynamic_cast<cPacket *>(event)) {
+            packetsInFlight++;
+            packetBytesInFlight += packet->getByteLength();
+        }
+    }
+
+    emit(gcsReportBytesSignal, (intval_t)usage.gcsReportBytes);
+    emit(gcsReportsSignal, (intval_t)usage.gcsReports);
+    emit(reportsInFlightSignal, (intval_t)reportsInFlight);
+    emit(packetsInFlightSignal, (intval_t)packetsInFlight);
+    emit(packetBytesInFlightSignal, (intval_t)packetBytesInFlight);
+    emit(recorderBufferBytesSignal, (intval_t)usage.recorderBufferBytes);
+    emit(hostStateBytesSignal, (intval_t)usage.hostStateBytes);
+    emit(processRssSignal, (intval_t)getProcessRss());
+}
+
+void RidMemoryMonitor::collect(cModule *module, RidMemoryUsage& usage)
+{
+    // modules come and go (see RidOneOffServer), so the tree is walked every time
+    if (auto accounting = dynamic_cast<IRidMemoryAccounting *>(module))
+        accounting->accountMemory(usage);
+    for (cModule::SubmoduleIterator it(module); !it.end(); ++it)
+        collect(*it, usage);
+}
+
+size_t RidMemoryMonitor::getProcessRss()
+{
+    FILE *f = fopen("/proc/self/statm", "r");
+    if (f == nullptr)
+        return 0;
+    unsigned long size, resident;
+    bool ok = fscanf(f, "%lu %lu", &size, &resident) == 2;
+    fclose(f);
+    return ok ? resident * sysconf(_SC_PAGESIZE) : 0;
+}
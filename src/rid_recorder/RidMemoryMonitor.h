@@ -0,0 +1,47 @@
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+//
+
+#ifndef __RID_MEMORY_MONITOR_H
+#define __RID_MEMORY_MONITOR_H
+
+#include "inet/common/INETDefs.h"
+
+#include "RidMemoryAccounting.h"
+
+using namespace inet;
+
+class RidMemoryMonitor : public cSimpleModule
+{
+  protected:
+    simtime_t sampleInterval;
+    cMessage *sampleTimer = nullptr;
+
+    static simsignal_t gcsReportBytesSignal;
+    static simsignal_t gcsReportsSignal;
+    static simsignal_t reportsInFlightSignal;
+    static simsignal_t packetsInFlightSignal;
+    static simsignal_t packetBytesInFlightSignal;
+    static simsignal_t recorderBufferBytesSignal;
+    static simsignal_t hostStateBytesSignal;
+    static simsignal_t processRssSignal;
+
+  public:
+    virtual ~RidMemoryMonitor();
+
+  protected:
+    virtual void initialize() override;
+    virtual void handleMessage(cMessage *msg) override;
+    virtual void finish() override;
+
+    /** Utility function: takes one sample of everything */
+    virtual void sample();
+
+    /** Utility function: adds up the usage of all accounting modules below module */
+    void collect(cModule *module, RidMemoryUsage& usage);
+
+    /** Utility function: resident set size of this process in bytes, 0 if unknown */
+    static size_t getProcessRss();
+};
+
+#endif
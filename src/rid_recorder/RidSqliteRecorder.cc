@@ -0,0 +1,229 @@
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+//
+
+#include "RidSqliteRecorder.h"
+
+#include "inet/common/ModuleAccess.h"
+#include "inet/mobility/contract/IMobility.h"
+#include "inet/physicallayer/wireless/common/contract/packetlevel/SignalTag_m.h"
+
+#include "detectors/rssi_mlat/RssiMlatGcs.h"
+#include "rid_beacon/RidBeaconFrame_m.h"
+#include "rid_beacon/RidBeaconMgmt.h"
+
+#include <cstdio>
+
+using namespace inet::physicallayer;
+
+Define_Module(RidSqliteRecorder);
+
+static const char *schema = R"(
+    CREATE TABLE host (
+        host INTEGER PRIMARY KEY,
+        serial_number INTEGER NOT NULL,
+        path TEXT NOT NULL
+    );
+    CREATE TABLE transmission (
+        tx_serial INTEGER NOT NULL,
+        tx_host INTEGER NOT NULL REFERENCES host(host),
+        time REAL NOT NULL,
+        timestamp INTEGER NOT NULL,
+        x REAL, y REAL, z REAL,
+        speed_vertical REAL, speed_horizontal REAL, heading REAL
+    );
+    CREATE TABLE reception (
+        tx_serial INTEGER NOT NULL,
+        rx_host INTEGER NOT NULL REFERENCES host(host),
+        time REAL NOT NULL,
+        rssi REAL,
+        timestamp INTEGER NOT NULL,
+        tx_x REAL, tx_y REAL, tx_z REAL,
+        rx_x REAL, rx_y REAL, rx_z REAL
+    );
+    CREATE TABLE fix (
+        tx_serial INTEGER NOT NULL,
+        timestamp INTEGER NOT NULL,
+        time REAL NOT NULL,
+        x REAL, y REAL, z REAL,
+        tx_x REAL, tx_y REAL, tx_z REAL,
+        num_reports INTEGER
+    );
+)";
+
+// built after the bulk inserts, which is much faster than maintaining them
+static const char *indices = R"(
+    CREATE INDEX IF NOT EXISTS transmission_serial_time ON transmission(tx_serial, time);
+    CREATE INDEX IF NOT EXISTS transmission_time ON transmission(time);
+    CREATE INDEX IF NOT EXISTS reception_serial_time ON reception(tx_serial, rx_host, time);
+    CREATE INDEX IF NOT EXISTS reception_rx_time ON reception(rx_host, time);
+    CREATE INDEX IF NOT EXISTS reception_time ON reception(time);
+    CREATE INDEX IF NOT EXISTS fix_serial_time ON fix(tx_serial, time);
+)";
+
+RidSqliteRecorder::~RidSqliteRecorder()
+{
+    // normally done in finish(), but not after an error
+    sqlite3_finalize(insertHost);
+    sqlite3_finalize(insertTransmission);
+    sqlite3_finalize(insertReception);
+    sqlite3_finalize(insertFix);
+    if (db != nullptr)
+        sqlite3_close(db);
+}
+
+void RidSqliteRecorder::accountMemory(RidMemoryUsage& usage) const
+{
+    // page cache and pending transaction, as far as SQLite knows
+    if (db != nullptr)
+        usage.recorderBufferBytes += sqlite3_memory_used();
+}
+
+void RidSqliteRecorder::initialize(int stage)
+{
+    if (stage == INITSTAGE_LOCAL) {
+        databaseFile = par("databaseFile").stdstringValue();
+        batchSize = par("batchSize");
+
+        std::remove(databaseFile.c_str());
+        if (sqlite3_open(databaseFile.c_str(), &db) != SQLITE_OK)
+            throw cRuntimeError("Cannot open database '%s': %s", databaseFile.c_str(), sqlite3_errmsg(db));
+        // results are rewritten from scratch if the run dies, no need for durability
+        execute("PRAGMA journal_mode = OFF; PRAGMA synchronous = OFF;");
+        execute(schema);
+
+        insertHost = prepare("INSERT INTO host VALUES (?, ?, ?)");
+        insertTransmission = prepare("INSERT INTO transmission VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?)");
+        insertReception = prepare("INSERT INTO reception VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)");
+        insertFix = prepare("INSERT INTO fix VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?)");
+
+        cModule *network = getSystemModule();
+        network->subscribe(RidBeaconMgmt::beaconSentSignal, this);
+        network->subscribe(RidBeaconMgmt::beaconReceivedSignal, this);
+        network->subscribe(RssiMlatGcs::fixComputedSignal, this);
+    }
+    else if (stage == INITSTAGE_LAST) {
+        execute("BEGIN");
+        cModule *network = getSystemModule();
+        for (int i = 0; i < network->getSubmoduleVectorSize("host"); i++) {
+            cModule *host = network->getSubmodule("host", i);
+            if (host == nullptr)
+                continue;
+            sqlite3_bind_int(insertHost, 1, i);
+            sqlite3_bind_int64(insertHost, 2, host->getModuleByPath(".wlan[0].mgmt")->par("serialNumber").intValue());
+            sqlite3_bind_text(insertHost, 3, host->getFullPath().c_str(), -1, SQLITE_TRANSIENT);
+            insert(insertHost);
+        }
+    }
+}
+
+void RidSqliteRecorder::finish()
+{
+    close();
+}
+
+void RidSqliteRecorder::receiveSignal(cComponent *source, simsignal_t signalID, cObject *obj, cObject *details)
+{
+    if (db == nullptr)
+        return;
+
+    if (signalID == RssiMlatGcs::fixComputedSignal) {
+        auto fix = check_and_cast<RssiMlatGcs::Fix *>(obj);
+        sqlite3_bind_int(insertFix, 1, fix->senderSerialNumber);
+        sqlite3_bind_int64(insertFix, 2, fix->timestamp);
+        sqlite3_bind_double(insertFix, 3, fix->time.dbl());
+        sqlite3_bind_double(insertFix, 4, fix->x);
+        sqlite3_bind_double(insertFix, 5, fix->y);
+        sqlite3_bind_double(insertFix, 6, fix->z);
+        sqlite3_bind_double(insertFix, 7, fix->txPosX);
+        sqlite3_bind_double(insertFix, 8, fix->txPosY);
+        sqlite3_bind_double(insertFix, 9, fix->txPosZ);
+        sqlite3_bind_int(insertFix, 10, fix->numReports);
+        insert(insertFix);
+        return;
+    }
+
+    auto packet = check_and_cast<Packet *>(obj);
+    auto beaconBody = packet->peekAtFront<RidBeaconFrame>();
+    cModule *host = getContainingNode(check_and_cast<cModule *>(source));
+
+    if (signalID == RidBeaconMgmt::beaconSentSignal) {
+        sqlite3_bind_int(insertTransmission, 1, beaconBody->getSerialNumber());
+        sqlite3_bind_int(insertTransmission, 2, host->getIndex());
+        sqlite3_bind_double(insertTransmission, 3, simTime().dbl());
+        sqlite3_bind_int64(insertTransmission, 4, beaconBody->getTimestamp());
+        sqlite3_bind_double(insertTransmission, 5, beaconBody->getPosX());
+        sqlite3_bind_double(insertTransmission, 6, beaconBody->getPosY());
+        sqlite3_bind_double(insertTransmission, 7, beaconBody->getPosZ());
+        sqlite3_bind_double(insertTransmission, 8, beaconBody->getSpeedVertical());
+        sqlite3_bind_double(insertTransmission, 9, beaconBody->getSpeedHorizontal());
+        sqlite3_bind_double(insertTransmission, 10, beaconBody->getHeading());
+        insert(insertTransmission);
+    }
+    else if (signalID == RidBeaconMgmt::beaconReceivedSignal) {
+        auto mobility = check_and_cast<IMobility *>(host->getSubmodule("mobility"));
+        Coord position = mobility->getCurrentPosition();
+        auto signalPowerInd = packet->findTag<SignalPowerInd>();
+        auto signalTimeInd = packet->findTag<SignalTimeInd>();
+
+        sqlite3_bind_int(insertReception, 1, beaconBody->getSerialNumber());
+        sqlite3_bind_int(insertReception, 2, host->getIndex());
+        sqlite3_bind_double(insertReception, 3, signalTimeInd != nullptr ? signalTimeInd->getStartTime().dbl() : simTime().dbl());
+        if (signalPowerInd != nullptr)
+            sqlite3_bind_double(insertReception, 4, 10 * std::log10(signalPowerInd->getPower().get() * 1000));
+        else
+            sqlite3_bind_null(insertReception, 4);
+        sqlite3_bind_int64(insertReception, 5, beaconBody->getTimestamp());
+        sqlite3_bind_double(insertReception, 6, beaconBody->getPosX());
+        sqlite3_bind_double(insertReception, 7, beaconBody->getPosY());
+        sqlite3_bind_double(insertReception, 8, beaconBody->getPosZ());
+        sqlite3_bind_double(insertReception, 9, position.x);
+        sqlite3_bind_double(insertReception, 10, position.y);
+        sqlite3_bind_double(insertReception, 11, position.z);
+        insert(insertReception);
+    }
+}
+
+void RidSqliteRecorder::execute(const char *sql)
+{
+    char *error = nullptr;
+    if (sqlite3_exec(db, sql, nullptr, nullptr, &error) != SQLITE_OK) {
+        std::string message = error ? error : "unknown error";
+        sqlite3_free(error);
+        throw cRuntimeError("SQLite error in '%s': %s", databaseFile.c_str(), message.c_str());
+    }
+}
+
+sqlite3_stmt *RidSqliteRecorder::prepare(const char *sql)
+{
+    sqlite3_stmt *statement = nullptr;
+    if (sqlite3_prepare_v2(db, sql, -1, &statement, nullptr) != SQLITE_OK)
+        throw cRuntimeError("SQLite error in '%s': %s", databaseFile.c_str(), sqlite3_errmsg(db));
+    return statement;
+}
+
+void RidSqliteRecorder::insert(sqlite3_stmt *statement)
+{
+    if (sqlite3_step(statement) != SQLITE_DONE)
+        throw cRuntimeError("SQLite error in '%s': %s", databaseFile.c_str(), sqlite3_errmsg(db));
+    sqlite3_reset(statement);
+    if (++rowsInTransaction >= batchSize) {
+        execute("COMMIT; BEGIN");
+        rowsInTransaction = 0;
+    }
+}
+
+void RidSqliteRecorder::close()
+{
+    if (db == nullptr)
+        return;
+    execute("COMMIT");
+    execute(indices);
+    sqlite3_finalize(insertHost);
+    sqlite3_finalize(insertTransmission);
+    sqlite3_finalize(insertReception);
+    sqlite3_finalize(insertFix);
+    insertHost = insertTransmission = insertReception = insertFix = nullptr;
+    sqlite3_close(db);
+    db = nullptr;
+}
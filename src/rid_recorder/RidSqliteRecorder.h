@@ -0,0 +1,55 @@
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+//
+
+#ifndef __RID_SQLITE_RECORDER_H
+#define __RID_SQLITE_RECORDER_H
+
+#include "inet/common/INETDefs.h"
+
+#include "RidMemoryAccounting.h"
+
+#include <sqlite3.h>
+
+using namespace inet;
+
+class RidSqliteRecorder : public cSimpleModule, protected cListener, public IRidMemoryAccounting
+{
+  protected:
+    std::string databaseFile;
+    int batchSize;
+
+    sqlite3 *db = nullptr;
+    sqlite3_stmt *insertHost = nullptr;
+    sqlite3_stmt *insertTransmission = nullptr;
+    sqlite3_stmt *insertReception = nullptr;
+    sqlite3_stmt *insertFix = nullptr;
+    int rowsInTransaction = 0;
+
+  public:
+    virtual ~RidSqliteRecorder();
+
+    virtual void accountMemory(RidMemoryUsage& usage) const override;
+
+  protected:
+    virtual int numInitStages() const override { return NUM_INIT_STAGES; }
+    virtual void initialize(int stage) override;
+    virtual void handleMessage(cMessage *msg) override { throw cRuntimeError("This module does not handle messages"); }
+    virtual void finish() override;
+
+    virtual void receiveSignal(cComponent *source, simsignal_t signalID, cObject *obj, cObject *details) override;
+
+    /** Utility function: runs SQL without results */
+    void execute(const char *sql);
+
+    /** Utility function: prepares a statement */
+    sqlite3_stmt *prepare(const char *sql);
+
+    /** Utility function: executes and resets a bound statement, committing every batchSize rows */
+    void insert(sqlite3_stmt *statement);
+
+    /** Utility function: closes the database, committing what is pending */
+    void close();
+};
+
+#endif
@@ -0,0 +1,243 @@
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+//
+
+#ifndef __JSON_H
+#define __JSON_H
+
+#include <charconv>
+#include <cstdlib>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace utils
+{
+    //
+    // Minimal JSON document model for the small request and reply objects
+    // exchanged with external tooling. Numbers are kept as doubles.
+    //
+    struct JsonValue
+    {
+        enum Type { NUL, BOOL, NUMBER, STRING, ARRAY, OBJECT };
+
+        Type type = NUL;
+        bool boolean = false;
+        double number = 0;
+        std::string string;
+        std::vector<JsonValue> array;
+        std::map<std::string, JsonValue> object;
+
+        bool has(const std::string& key) const {
+            return type == OBJECT && object.count(key) > 0;
+        }
+
+        const JsonValue& operator[](const std::string& key) const {
+            if (type != OBJECT)
+                throw std::runtime_error("JSON value is not an object");
+            auto it = object.find(key);
+            if (it == object.end())
+                throw std::runtime_error("missing JSON key '" + key + "'");
+            return it->second;
+        }
+
+        const JsonValue& operator[](size_t index) const {
+            if (type != ARRAY)
+                throw std::runtime_error("JSON value is not an array");
+            if (index >= array.size())
+                throw std::runtime_error("JSON array index out of range");
+            return array[index];
+        }
+
+        size_t size() const {
+            return type == ARRAY ? array.size() : type == OBJECT ? object.size() : 0;
+        }
+
+        double asDouble() const {
+            if (type != NUMBER)
+                throw std::runtime_error("JSON value is not a number");
+            return number;
+        }
+
+        int asInt() const {
+            return (int)asDouble();
+        }
+
+        const std::string& asString() const {
+            if (type != STRING)
+                throw std::runtime_error("JSON value is not a string");
+            return string;
+        }
+    };
+
+    class JsonParser
+    {
+      protected:
+        const std::string& text;
+        size_t pos = 0;
+
+        void skipWhitespace() {
+            while (pos < text.size() && (text[pos] == ' ' || text[pos] == '\t' || text[pos] == '\n' || text[pos] == '\r'))
+                pos++;
+        }
+
+        [[noreturn]] void fail(const char *what) {
+            throw std::runtime_error(std::string("JSON parse error: ") + what + " at offset " + std::to_string(pos));
+        }
+
+        void expect(char c) {
+            skipWhitespace();
+            if (pos >= text.size() || text[pos] != c)
+                fail("unexpected character");
+            pos++;
+        }
+
+        bool consume(const char *literal) {
+            size_t n = std::char_traits<char>::length(literal);
+            if (text.compare(pos, n, literal) != 0)
+                return false;
+            pos += n;
+            return true;
+        }
+
+        std::string parseString() {
+            expect('"');
+            std::string result;
+            while (pos < text.size() && text[pos] != '"') {
+                char c = text[pos++];
+                if (c == '\\') {
+                    if (pos >= text.size())
+                        fail("unterminated escape");
+                    char e = text[pos++];
+                    switch (e) {
+                        case 'n': result += '\n'; break;
+                        case 't': result += '\t'; break;
+                        case 'r': result += '\r'; break;
+                        case 'b': result += '\b'; break;
+                        case 'f': result += '\f'; break;
+                        case 'u': fail("unicode escapes are not supported");
+                        default: result += e; break;
+                    }
+                }
+                else
+                    result += c;
+            }
+            expect('"');
+            return result;
+        }
+
+        JsonValue parseValue() {
+            skipWhitespace();
+            if (pos >= text.size())
+                fail("unexpected end of input");
+            JsonValue value;
+            char c = text[pos];
+            if (c == '{') {
+                value.type = JsonValue::OBJECT;
+                pos++;
+                skipWhitespace();
+                if (pos < text.size() && text[pos] == '}') {
+                    pos++;
+                    return value;
+                }
+                while (true) {
+                    skipWhitespace();
+                    std::string key = parseString();
+                    expect(':');
+                    value.object[key] = parseValue();
+                    skipWhitespace();
+                    if (pos < text.size() && text[pos] == ',') {
+                        pos++;
+                        continue;
+                    }
+                    expect('}');
+                    return value;
+                }
+            }
+            else if (c == '[') {
+                value.type = JsonValue::ARRAY;
+                pos++;
+                skipWhitespace();
+                if (pos < text.size() && text[pos] == ']') {
+                    pos++;
+                    return value;
+                }
+                while (true) {
+                    value.array.push_back(parseValue());
+                    skipWhitespace();
+                    if (pos < text.size() && text[pos] == ',') {
+                        pos++;
+                        continue;
+                    }
+                    expect(']');
+                    return value;
+                }
+            }
+            else if (c == '"') {
+                value.type = JsonValue::STRING;
+                value.string = parseString();
+            }
+            else if (consume("true")) {
+                value.type = JsonValue::BOOL;
+                value.boolean = true;
+            }
+            else if (consume("false")) {
+                value.type = JsonValue::BOOL;
+            }
+            else if (consume("null")) {
+                value.type = JsonValue::NUL;
+            }
+            else {
+                const char *begin = text.c_str() + pos;
+                char *end;
+                value.type = JsonValue::NUMBER;
+                value.number = std::strtod(begin, &end);
+                if (end == begin)
+                    fail("invalid value");
+                pos += end - begin;
+            }
+            return value;
+        }
+
+      public:
+        explicit JsonParser(const std::string& text) : text(text) {}
+
+        JsonValue parse() {
+            JsonValue value = parseValue();
+            skipWhitespace();
+            if (pos != text.size())
+                fail("trailing characters");
+            return value;
+        }
+    };
+
+    inline JsonValue json_parse(const std::string& text) {
+        return JsonParser(text).parse();
+    }
+
+    inline std::string json_quote(const std::string& s) {
+        std::string result = "\"";
+        for (char c : s) {
+            switch (c) {
+                case '"': result += "\\\""; break;
+                case '\\': result += "\\\\"; break;
+                case '\n': result += "\\n"; break;
+                case '\t': result += "\\t"; break;
+                case '\r': result += "\\r"; break;
+                default: result += c; break;
+            }
+        }
+        return result + "\"";
+    }
+
+    /** Shortest text that reads back as exactly the same double */
+    inline std::string json_number(double value) {
+        char buf[32];
+        auto result = std::to_chars(buf, buf + sizeof(buf), value);
+        return std::string(buf, result.ptr);
+    }
+}
+
+#endif
@@ -0,0 +1,123 @@
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+//
+
+#ifndef __NPY_WRITER_H
+#define __NPY_WRITER_H
+
+#include <cstdint>
+#include <cstdio>
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace utils
+{
+    template <typename T> inline const char *npy_dtype();
+    template <> inline const char *npy_dtype<double>() { return "<f8"; }
+    template <> inline const char *npy_dtype<float>() { return "<f4"; }
+    template <> inline const char *npy_dtype<int64_t>() { return "<i8"; }
+    template <> inline const char *npy_dtype<int32_t>() { return "<i4"; }
+    template <> inline const char *npy_dtype<uint8_t>() { return "|u1"; }
+
+    //
+    // Streams rows of a fixed shape into a NumPy .npy file (format 1.0,
+    // little endian hosts). Rows are collected in a preallocated buffer and
+    // written in large chunks. The header reserves room for any row count,
+    // which is filled in by close(), so numpy.load() sees shape (N, ...).
+    //
+    template <typename T>
+    class NpyWriter
+    {
+      protected:
+        static constexpr size_t headerSize = 128;
+
+        FILE *file = nullptr;
+        std::string path;
+        std::vector<size_t> rowShape;
+        size_t rowSize = 1;
+        std::vector<T> buffer;
+        size_t buffered = 0;
+        uint64_t numRows = 0;
+
+        std::string makeHeader() const {
+            std::string shape = "(" + std::to_string(numRows) + ",";
+            for (size_t i = 0; i < rowShape.size(); i++)
+                shape += (i ? ", " : " ") + std::to_string(rowShape[i]);
+            shape += ")";
+            std::string dict = std::string("{'descr': '") + npy_dtype<T>() + "', 'fortran_order': False, 'shape': " + shape + ", }";
+            // magic, version and header length take 10 bytes, the dict is padded with spaces and ends in a newline
+            std::string header = std::string("\x93NUMPY\x01\x00", 8);
+            uint16_t length = headerSize - 10;
+            header += (char)(length & 0xff);
+            header += (char)(length >> 8);
+            if (dict.size() + 1 > length)
+                throw std::runtime_error("npy header too long for " + path);
+            header += dict;
+            header.append(length - dict.size() - 1, ' ');
+            header += '\n';
+            return header;
+        }
+
+        void flush() {
+            if (buffered > 0 && std::fwrite(buffer.data(), sizeof(T), buffered, file) != buffered)
+                throw std::runtime_error("cannot write " + path);
+            buffered = 0;
+        }
+
+      public:
+        /** rowShape is the shape of one row, empty for a vector of scalars */
+        NpyWriter(const std::string& path, const std::vector<size_t>& rowShape, size_t bufferBytes = 1 << 20) : path(path), rowShape(rowShape) {
+            for (size_t n : rowShape)
+                rowSize *= n;
+            buffer.resize(std::max(rowSize, bufferBytes / sizeof(T)));
+            file = std::fopen(path.c_str(), "wb");
+            if (file == nullptr)
+                throw std::runtime_error("cannot open " + path);
+            std::string header = makeHeader();
+            std::fwrite(header.data(), 1, header.size(), file);
+        }
+
+        ~NpyWriter() {
+            try {
+                close();
+            }
+            catch (...) {
+            }
+        }
+
+        NpyWriter(const NpyWriter&) = delete;
+        NpyWriter& operator=(const NpyWriter&) = delete;
+
+        size_t getRowSize() const { return rowSize; }
+        uint64_t getNumRows() const { return numRows; }
+        size_t getBufferBytes() const { return buffer.capacity() * sizeof(T); }
+
+        /** Appends one row of getRowSize() values */
+        void append(const T *row) {
+            if (buffered + rowSize > buffer.size())
+                flush();
+            std::memcpy(buffer.data() + buffered, row, rowSize * sizeof(T));
+            buffered += rowSize;
+            numRows++;
+        }
+
+        /** Writes the remaining rows and the final row count */
+        void close() {
+            if (file == nullptr)
+                return;
+            FILE *f = file;
+            flush();
+            std::string header = makeHeader();
+            bool ok = std::fseek(f, 0, SEEK_SET) == 0 && std::fwrite(header.data(), 1, header.size(), f) == header.size();
+            file = nullptr;
+            ok = std::fclose(f) == 0 && ok;
+            if (!ok)
+                throw std::runtime_error("cannot finish " + path);
+        }
+    };
+}
+
+#endif
@@ -0,0 +1,149 @@
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+//
+
+#ifndef __RUNNING_STATS_H
+#define __RUNNING_STATS_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace utils
+{
+    //
+    // Count, mean, variance, min and max of a stream of values in constant
+    // memory. Uses Welford's update, which stays accurate where the naive
+    // sum of squares cancels out (e.g. RSSI values around -80 dBm).
+    //
+    class RunningStats
+    {
+      protected:
+        uint64_t count = 0;
+        double mean = 0;
+        double m2 = 0;
+        double min = std::numeric_limits<double>::infinity();
+        double max = -std::numeric_limits<double>::infinity();
+
+      public:
+        void add(double value) {
+            count++;
+            double delta = value - mean;
+            mean += delta / count;
+            m2 += delta * (value - mean);
+            if (value < min)
+                min = value;
+            if (value > max)
+                max = value;
+        }
+
+        uint64_t getCount() const { return count; }
+        double getMean() const { return count > 0 ? mean : NAN; }
+        /** sample variance, NaN below two values */
+        double getVariance() const { return count > 1 ? m2 / (count - 1) : NAN; }
+        double getStddev() const { return std::sqrt(getVariance()); }
+        double getMin() const { return count > 0 ? min : NAN; }
+        double getMax() const { return count > 0 ? max : NAN; }
+
+        /** half-width of the Student t confidence interval of the mean, NaN below two values */
+        double getHalfWidth(double confidence) const;
+    };
+
+    /** Regularized incomplete beta function I_x(a, b), continued fraction evaluated with Lentz's method */
+    inline double incomplete_beta(double a, double b, double x) {
+        if (x <= 0)
+            return 0;
+        if (x >= 1)
+            return 1;
+        // the fraction converges quickly only below the mean, use the symmetry above it
+        if (x > (a + 1) / (a + b + 2))
+            return 1 - incomplete_beta(b, a, 1 - x);
+        const double tiny = 1e-300;
+        double front = std::exp(std::lgamma(a + b) - std::lgamma(a) - std::lgamma(b) + a * std::log(x) + b * std::log1p(-x)) / a;
+        double c = 1;
+        double d = 1 - (a + b) * x / (a + 1);
+        d = 1 / (std::abs(d) < tiny ? tiny : d);
+        double h = d;
+        for (int m = 1; m <= 300; m++) {
+            for (int odd = 0; odd < 2; odd++) {
+                double numerator = odd ? -(a + m) * (a + b + m) * x / ((a + 2 * m) * (a + 2 * m + 1))
+                                       : m * (b - m) * x / ((a + 2 * m - 1) * (a + 2 * m));
+                d = 1 + numerator * d;
+                d = 1 / (std::abs(d) < tiny ? tiny : d);
+                c = 1 + numerator / c;
+                if (std::abs(c) < tiny)
+                    c = tiny;
+                h *= c * d;
+                if (odd && std::abs(c * d - 1) < 1e-15)
+                    return front * h;
+            }
+        }
+        return front * h;
+    }
+
+    /** Quantile of Student's t distribution, 0 < p < 1 */
+    inline double student_t_quantile(double p, uint64_t dof) {
+        double q = p < 0.5 ? 1 - p : p;
+        double v = dof;
+        double t;
+        if (dof == 1)
+            t = std::tan(M_PI * (q - 0.5));
+        else if (dof == 2)
+            t = (2 * q - 1) / std::sqrt(2 * q * (1 - q));
+        else {
+            // Newton's method on the CDF from 0, which is concave there so it converges monotonically
+            double logDensity = std::lgamma((v + 1) / 2) - std::lgamma(v / 2) - 0.5 * std::log(v * M_PI);
+            t = 0;
+            for (int i = 0; i < 100; i++) {
+                double cdf = 1 - 0.5 * incomplete_beta(v / 2, 0.5, v / (v + t * t));
+                double pdf = std::exp(logDensity - (v + 1) / 2 * std::log1p(t * t / v));
+                double step = (cdf - q) / pdf;
+                t -= step;
+                if (std::abs(step) < 1e-12 * std::max(1.0, t))
+                    break;
+            }
+        }
+        return p < 0.5 ? -t : t;
+    }
+
+    inline double RunningStats::getHalfWidth(double confidence) const {
+        if (count < 2)
+            return NAN;
+        return student_t_quantile((1 + confidence) / 2, count - 1) * getStddev() / std::sqrt((double)count);
+    }
+
+    //
+    // Histogram with equal-width bins over [lo, hi), plus one underflow and
+    // one overflow bin, so no value is ever lost.
+    //
+    class FixedHistogram
+    {
+      protected:
+        double lo;
+        double binWidth;
+        // underflow, bins..., overflow
+        std::vector<uint64_t> counts;
+
+      public:
+        FixedHistogram(double lo, double hi, int numBins) : lo(lo), binWidth((hi - lo) / numBins), counts(numBins + 2) {}
+
+        void add(double value) {
+            double position = (value - lo) / binWidth;
+            size_t bin;
+            if (!(position >= 0))
+                bin = 0;
+            else if (position >= counts.size() - 2)
+                bin = counts.size() - 1;
+            else
+                bin = (size_t)position + 1;
+            counts[bin]++;
+        }
+
+        /** underflow count first, overflow count last */
+        const std::vector<uint64_t>& getCounts() const { return counts; }
+    };
+}
+
+#endif
@@ -0,0 +1,79 @@
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+//
+
+#ifndef __SPSC_RING_H
+#define __SPSC_RING_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+
+namespace utils
+{
+    //
+    // Bounded lock-free queue for exactly one producer and one consumer
+    // thread. The capacity is rounded up to a power of two. Head and tail
+    // live on separate cache lines, and each side caches the other's index
+    // so that it only touches the shared one when it seems full or empty.
+    //
+    template <typename T>
+    class SpscRing
+    {
+      protected:
+        static constexpr size_t cacheLine = 64;
+
+        std::unique_ptr<T[]> items;
+        size_t mask;
+
+        alignas(cacheLine) std::atomic<size_t> head{0}; // next slot to read, written by the consumer
+        size_t cachedTail = 0;
+        alignas(cacheLine) std::atomic<size_t> tail{0}; // next slot to write, written by the producer
+        size_t cachedHead = 0;
+
+      public:
+        explicit SpscRing(size_t capacity) {
+            if (capacity == 0)
+                throw std::invalid_argument("SpscRing capacity must be positive");
+            size_t n = 1;
+            while (n < capacity)
+                n <<= 1;
+            items.reset(new T[n]);
+            mask = n - 1;
+        }
+
+        size_t capacity() const { return mask + 1; }
+
+        /** Producer side: false if the ring is full */
+        bool tryPush(const T& item) {
+            size_t t = tail.load(std::memory_order_relaxed);
+            if (t - cachedHead > mask) {
+                cachedHead = head.load(std::memory_order_acquire);
+                if (t - cachedHead > mask)
+                    return false;
+            }
+            items[t & mask] = item;
+            tail.store(t + 1, std::memory_order_release);
+            return true;
+        }
+
+        /** Consumer side: pops up to n items into out, returns how many */
+        size_t tryPop(T *out, size_t n) {
+            size_t h = head.load(std::memory_order_relaxed);
+            if (cachedTail == h) {
+                cachedTail = tail.load(std::memory_order_acquire);
+                if (cachedTail == h)
+                    return 0;
+            }
+            size_t count = std::min(n, cachedTail - h);
+            for (size_t i = 0; i < count; i++)
+                out[i] = items[(h + i) & mask];
+            head.store(h + count, std::memory_order_release);
+            return count;
+        }
+    };
+}
+
+#endif
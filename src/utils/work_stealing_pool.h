@@ -0,0 +1,159 @@
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+//
+
+#ifndef __WORK_STEALING_POOL_H
+#define __WORK_STEALING_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace utils
+{
+    //
+    // Fixed set of worker threads that run index ranges in parallel. Each
+    // participant owns a deque of indices, pops work from its back and steals
+    // from the front of the others once it runs dry. The calling thread takes
+    // part in the work, so a pool with N threads uses N + 1 cores.
+    //
+    class WorkStealingPool
+    {
+      protected:
+        struct Queue {
+            std::mutex mutex;
+            std::deque<size_t> items;
+        };
+
+        std::vector<std::thread> threads;
+        std::vector<std::unique_ptr<Queue>> queues;
+
+        std::mutex mutex;
+        std::condition_variable workAvailable;
+        std::condition_variable workDone;
+        const std::function<void(size_t)> *task = nullptr;
+        uint64_t generation = 0;
+        bool stopping = false;
+        std::atomic<size_t> remaining{0};
+        int active = 0;
+        std::exception_ptr error;
+
+        bool pop(size_t self, size_t& index) {
+            // own queue first, newest item for locality
+            {
+                Queue& own = *queues[self];
+                std::lock_guard<std::mutex> lock(own.mutex);
+                if (!own.items.empty()) {
+                    index = own.items.back();
+                    own.items.pop_back();
+                    return true;
+                }
+            }
+            // then steal the oldest item of someone else
+            for (size_t i = 1; i < queues.size(); i++) {
+                Queue& victim = *queues[(self + i) % queues.size()];
+                std::lock_guard<std::mutex> lock(victim.mutex);
+                if (!victim.items.empty()) {
+                    index = victim.items.front();
+                    victim.items.pop_front();
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        void drain(size_t self, const std::function<void(size_t)>& f) {
+            size_t index;
+            while (pop(self, index)) {
+                try {
+                    f(index);
+                }
+                catch (...) {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    if (!error)
+                        error = std::current_exception();
+                }
+                if (remaining.fetch_sub(1) == 1) {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    workDone.notify_all();
+                }
+            }
+        }
+
+        void run(size_t self) {
+            uint64_t seen = 0;
+            while (true) {
+                const std::function<void(size_t)> *f;
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    workAvailable.wait(lock, [&] { return stopping || (task != nullptr && generation != seen); });
+                    if (stopping)
+                        return;
+                    seen = generation;
+                    f = task;
+                    active++;
+                }
+                drain(self, *f);
+                {
+                    // the caller must not reuse the queues while anyone still looks at them
+                    std::lock_guard<std::mutex> lock(mutex);
+                    active--;
+                    workDone.notify_all();
+                }
+            }
+        }
+
+      public:
+        explicit WorkStealingPool(int numThreads) {
+            for (int i = 0; i <= numThreads; i++)
+                queues.push_back(std::make_unique<Queue>());
+            for (int i = 1; i <= numThreads; i++)
+                threads.emplace_back(&WorkStealingPool::run, this, i);
+        }
+
+        ~WorkStealingPool() {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                stopping = true;
+            }
+            workAvailable.notify_all();
+            for (auto& thread : threads)
+                thread.join();
+        }
+
+        int getNumThreads() const { return threads.size(); }
+
+        /** Calls f(i) for every i in [0, n) and returns once all calls are done */
+        void parallelFor(size_t n, const std::function<void(size_t)>& f) {
+            if (n == 0)
+                return;
+            for (size_t i = 0; i < n; i++) {
+                Queue& queue = *queues[i % queues.size()];
+                std::lock_guard<std::mutex> lock(queue.mutex);
+                queue.items.push_back(i);
+            }
+            remaining = n;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                task = &f;
+                error = nullptr;
+                generation++;
+            }
+            workAvailable.notify_all();
+            drain(0, f);
+            std::unique_lock<std::mutex> lock(mutex);
+            workDone.wait(lock, [&] { return remaining == 0 && active == 0; });
+            task = nullptr;
+            if (error)
+                std::rethrow_exception(error);
+        }
+    };
+}
+
+#endif